@@ -0,0 +1,43 @@
+// AudioCommandQueue class definitions
+
+#include "audio_command_queue.h"
+
+namespace audio_manager {
+
+    /*** Constructor, starts empty ***/
+    AudioCommandQueue::AudioCommandQueue(void) : head_(0), tail_(0) {}
+
+
+    /*** Add a command to the back of the queue, game thread only ***/
+    bool AudioCommandQueue::Push(const AudioCommand& command) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & (AUDIO_COMMAND_QUEUE_SIZE - 1);
+
+        // full, the consumer hasn't caught up yet
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        // write the slot first, then publish it
+        commands_[tail] = command;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+
+    /*** Take the command at the front of the queue, audio thread only ***/
+    bool AudioCommandQueue::Pop(AudioCommand& command) {
+        size_t head = head_.load(std::memory_order_relaxed);
+
+        // empty
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        // read the slot first, then hand it back to the producer
+        command = commands_[head];
+        head_.store((head + 1) & (AUDIO_COMMAND_QUEUE_SIZE - 1), std::memory_order_release);
+        return true;
+    }
+
+} // namespace audio_manager
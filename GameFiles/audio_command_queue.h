@@ -0,0 +1,59 @@
+// AudioCommandQueue class declarations, a lock-free queue that carries playback requests
+// from the game thread to the audio thread
+
+#ifndef AUDIO_COMMAND_QUEUE_H_
+#define AUDIO_COMMAND_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+
+namespace audio_manager {
+
+    // Must be a power of two so indices can wrap with a mask
+    const size_t AUDIO_COMMAND_QUEUE_SIZE = 1024;
+
+    // Every kind of request the game thread can make of the audio thread
+    enum AudioCommandType {
+        PLAY_SOUND,
+        PLAY_SOUND_AT,
+        STOP_SOUND,
+        SET_SOUND_POSITION,
+        SET_LOOP,
+        SET_LISTENER_POSITION,
+        SET_MASTER_GAIN,
+        SET_ATTENUATION
+    };
+
+    // A single request, unused fields are ignored by the audio thread
+    struct AudioCommand {
+        AudioCommandType type;
+        int index;
+        float x, y, z;
+        bool flag;
+    };
+
+    // Ring buffer for exactly one producer (game thread) and one consumer (audio thread)
+    class AudioCommandQueue {
+
+        public:
+            AudioCommandQueue(void);
+
+            // Producer side, returns false (and drops the command) if the queue is full
+            bool Push(const AudioCommand& command);
+
+            // Consumer side, returns false if there is nothing to read
+            bool Pop(AudioCommand& command);
+
+        private:
+            AudioCommand commands_[AUDIO_COMMAND_QUEUE_SIZE];
+
+            // head_ is only written by the consumer, tail_ only by the producer,
+            // kept on separate cache lines so the two threads don't fight over them
+            alignas(64) std::atomic<size_t> head_;
+            alignas(64) std::atomic<size_t> tail_;
+
+    }; // class AudioCommandQueue
+
+} // namespace audio_manager
+
+#endif // AUDIO_COMMAND_QUEUE_H_
@@ -0,0 +1,243 @@
+// Definitions for the AudioDecoder classes
+
+#include "audio_decoder.h"
+#include "audio_manager.h"
+
+// The implementation half of the single-file library lives in this translation unit only
+#ifdef USE_STB_VORBIS
+#include <stb_vorbis.c>
+#endif
+
+namespace audio_manager {
+
+    /*** Pick a decoder by file extension ***/
+    AudioDecoder* AudioDecoder::Open(const char *filename) {
+        std::string name(filename);
+        std::string extension = name.substr(name.find_last_of('.') + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        if (extension == "ogg") {
+#ifdef USE_STB_VORBIS
+            return new VorbisDecoder(filename);
+#else
+            throw(AudioManagerException(std::string("Built without Ogg Vorbis support")));
+#endif
+        }
+        return new WavDecoder(filename);
+    }
+
+
+    /*** Constructor, parses the RIFF header and leaves the file at the start of the samples ***/
+    WavDecoder::WavDecoder(const char *filename) : bytes_read_(0) {
+
+        file_.open(filename, std::ios::binary);
+        if (!file_) {
+            throw(AudioManagerException(std::string("Failed to open wav file")));
+        }
+
+        // Little-endian helpers for reading the header fields
+        auto read_u32 = [this](void) {
+            unsigned char b[4] = {};
+            file_.read(reinterpret_cast<char*>(b), 4);
+            return (unsigned int)(b[0] | (b[1] << 8) | (b[2] << 16) | (b[3] << 24));
+        };
+        auto read_u16 = [this](void) {
+            unsigned char b[2] = {};
+            file_.read(reinterpret_cast<char*>(b), 2);
+            return (unsigned short)(b[0] | (b[1] << 8));
+        };
+
+        // RIFF/WAVE signature
+        char id[4];
+        file_.read(id, 4);
+        read_u32();
+        char wave[4];
+        file_.read(wave, 4);
+        if (!file_ || std::string(id, 4) != "RIFF" || std::string(wave, 4) != "WAVE") {
+            throw(AudioManagerException(std::string("File is not a wav file")));
+        }
+
+        // Walk the chunks until both the format and the data have been found
+        unsigned short channels = 0, bits = 0;
+        bool found_fmt = false;
+        while (file_.read(id, 4)) {
+            unsigned int chunk_size = read_u32();
+            std::string chunk(id, 4);
+
+            if (chunk == "fmt ") {
+                unsigned short audio_format = read_u16();
+                channels = read_u16();
+                frequency_ = read_u32();
+                read_u32(); // byte rate
+                read_u16(); // block align
+                bits = read_u16();
+                if (audio_format != 1) {
+                    throw(AudioManagerException(std::string("Only PCM wav files are supported")));
+                }
+                file_.seekg(chunk_size - 16, std::ios::cur);
+                found_fmt = true;
+            }
+            else if (chunk == "data") {
+                data_start_ = file_.tellg();
+                data_size_ = chunk_size;
+                break;
+            }
+            else {
+                // chunks are padded to an even size
+                file_.seekg(chunk_size + (chunk_size & 1), std::ios::cur);
+            }
+        }
+
+        if (!found_fmt || !file_) {
+            throw(AudioManagerException(std::string("Malformed wav file")));
+        }
+
+        // Map the wav format to an OpenAL one
+        if (channels == 1 && bits == 8) {
+            format_ = AL_FORMAT_MONO8;
+        } else if (channels == 1 && bits == 16) {
+            format_ = AL_FORMAT_MONO16;
+        } else if (channels == 2 && bits == 8) {
+            format_ = AL_FORMAT_STEREO8;
+        } else if (channels == 2 && bits == 16) {
+            format_ = AL_FORMAT_STEREO16;
+        } else {
+            throw(AudioManagerException(std::string("Unsupported wav format")));
+        }
+    }
+
+
+    /*** Copy the next samples off the disk ***/
+    unsigned int WavDecoder::Read(char* data, unsigned int size) {
+        unsigned int remaining = data_size_ - bytes_read_;
+        unsigned int amount = std::min(size, remaining);
+        if (amount == 0) {
+            return 0;
+        }
+
+        file_.read(data, amount);
+        unsigned int got = static_cast<unsigned int>(file_.gcount());
+        bytes_read_ += got;
+
+        // Truncated file, treat what we have as the end
+        if (got < amount) {
+            data_size_ = bytes_read_;
+        }
+        return got;
+    }
+
+
+    /*** Seek back to the first sample ***/
+    void WavDecoder::Rewind(void) {
+        file_.clear();
+        file_.seekg(data_start_);
+        bytes_read_ = 0;
+    }
+
+
+#ifdef USE_STB_VORBIS
+    /*** Constructor, opens the file and reads the stream info ***/
+    VorbisDecoder::VorbisDecoder(const char *filename) {
+        int error = 0;
+        vorbis_ = stb_vorbis_open_filename(filename, &error, NULL);
+        if (!vorbis_) {
+            throw(AudioManagerException(std::string("Failed to open ogg file")));
+        }
+
+        stb_vorbis_info info = stb_vorbis_get_info(vorbis_);
+        channels_ = info.channels;
+        frequency_ = info.sample_rate;
+        if (channels_ == 1) {
+            format_ = AL_FORMAT_MONO16;
+        } else if (channels_ == 2) {
+            format_ = AL_FORMAT_STEREO16;
+        } else {
+            stb_vorbis_close(vorbis_);
+            throw(AudioManagerException(std::string("Unsupported ogg channel count")));
+        }
+    }
+
+
+    /*** Destructor ***/
+    VorbisDecoder::~VorbisDecoder() {
+        stb_vorbis_close(vorbis_);
+    }
+
+
+    /*** Decode the next samples, only ever whole frames ***/
+    unsigned int VorbisDecoder::Read(char* data, unsigned int size) {
+        int frame_size = channels_ * 2;
+        int shorts = (size / frame_size) * channels_;
+        int frames = stb_vorbis_get_samples_short_interleaved(vorbis_, channels_, reinterpret_cast<short*>(data), shorts);
+        return frames * frame_size;
+    }
+
+
+    /*** Seek back to the first sample ***/
+    void VorbisDecoder::Rewind(void) {
+        stb_vorbis_seek_start(vorbis_);
+    }
+#endif
+
+
+    /*** Size of one sample frame of an OpenAL format ***/
+    int BytesPerFrame(ALenum format) {
+        switch (format) {
+            case AL_FORMAT_MONO8:    return 1;
+            case AL_FORMAT_MONO16:   return 2;
+            case AL_FORMAT_STEREO8:  return 2;
+            case AL_FORMAT_STEREO16: return 4;
+        }
+        return 1;
+    }
+
+
+    /*** Decode a whole file, runs on a loader thread so it must not call into OpenAL ***/
+    DecodedSound DecodeSound(AudioDecoder* decoder, bool mono) {
+        DecodedSound sound;
+        sound.format = decoder->GetFormat();
+        sound.frequency = decoder->GetFrequency();
+
+        // Pull the file through in large chunks, the vector only grows a handful of times
+        const unsigned int CHUNK_SIZE = 65536;
+        unsigned int filled = 0;
+        try {
+            unsigned int got;
+            do {
+                sound.samples.resize(filled + CHUNK_SIZE);
+                got = decoder->Read(sound.samples.data() + filled, CHUNK_SIZE);
+                filled += got;
+            } while (got > 0);
+        }
+        catch (...) {
+            delete decoder;
+            throw;
+        }
+        delete decoder;
+        sound.samples.resize(filled);
+
+        // Average the channels in place, the mono samples never get ahead of the stereo ones being read
+        if (mono && sound.format == AL_FORMAT_STEREO16) {
+            short* samples = reinterpret_cast<short*>(sound.samples.data());
+            size_t frames = filled / 4;
+            for (size_t i = 0; i < frames; i++) {
+                samples[i] = (short)(((int)samples[2*i] + (int)samples[2*i + 1]) / 2);
+            }
+            sound.samples.resize(frames * 2);
+            sound.format = AL_FORMAT_MONO16;
+        }
+        else if (mono && sound.format == AL_FORMAT_STEREO8) {
+            // 8-bit samples are unsigned, centred on 128
+            unsigned char* samples = reinterpret_cast<unsigned char*>(sound.samples.data());
+            size_t frames = filled / 2;
+            for (size_t i = 0; i < frames; i++) {
+                samples[i] = (unsigned char)(((int)samples[2*i] + (int)samples[2*i + 1]) / 2);
+            }
+            sound.samples.resize(frames);
+            sound.format = AL_FORMAT_MONO8;
+        }
+
+        return sound;
+    }
+
+} // namespace audio_manager
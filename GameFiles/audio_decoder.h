@@ -0,0 +1,101 @@
+// AudioDecoder class declarations, turns audio files (wav, and ogg when stb_vorbis is available)
+// into raw PCM samples for OpenAL, either all at once or a chunk at a time for streaming
+
+#ifndef AUDIO_DECODER_H_
+#define AUDIO_DECODER_H_
+
+#include <AL/al.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef USE_STB_VORBIS
+#define STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.c>
+#undef STB_VORBIS_HEADER_ONLY
+#endif
+
+namespace audio_manager {
+
+    // Abstract decoder, every format hands out 8 or 16-bit interleaved PCM
+    class AudioDecoder {
+
+        public:
+            virtual ~AudioDecoder() {}
+
+            // Open a decoder for a file based on its extension, throws AudioManagerException on failure
+            static AudioDecoder* Open(const char *filename);
+
+            // Getters
+            inline ALenum GetFormat(void) const { return format_; }
+            inline ALsizei GetFrequency(void) const { return frequency_; }
+
+            // Decode up to size bytes of samples into data, returns the bytes written, 0 once the file is done
+            virtual unsigned int Read(char* data, unsigned int size) = 0;
+
+            // Go back to the first sample
+            virtual void Rewind(void) = 0;
+
+        protected:
+            ALenum format_;
+            ALsizei frequency_;
+
+    }; // class AudioDecoder
+
+
+    // Uncompressed PCM wav files, samples are copied straight off the disk
+    class WavDecoder : public AudioDecoder {
+
+        public:
+            WavDecoder(const char *filename);
+
+            unsigned int Read(char* data, unsigned int size) override;
+            void Rewind(void) override;
+
+        private:
+            std::ifstream file_;
+            std::streamoff data_start_;
+            unsigned int data_size_;
+            unsigned int bytes_read_;
+
+    }; // class WavDecoder
+
+
+#ifdef USE_STB_VORBIS
+    // Ogg Vorbis files, decoded to 16-bit samples with stb_vorbis
+    class VorbisDecoder : public AudioDecoder {
+
+        public:
+            VorbisDecoder(const char *filename);
+            ~VorbisDecoder();
+
+            unsigned int Read(char* data, unsigned int size) override;
+            void Rewind(void) override;
+
+        private:
+            stb_vorbis* vorbis_;
+            int channels_;
+
+    }; // class VorbisDecoder
+#endif
+
+
+    // A fully decoded sound, ready to be handed to alBufferData
+    struct DecodedSound {
+        std::vector<char> samples;
+        ALenum format;
+        ALsizei frequency;
+    };
+
+    // Size of one sample frame (all channels) of an OpenAL format
+    int BytesPerFrame(ALenum format);
+
+    /* Decode a whole file and delete the decoder, optionally averaging
+     * stereo down to mono. Touches no OpenAL state, so it is safe to run
+     * on a worker thread */
+    DecodedSound DecodeSound(AudioDecoder* decoder, bool mono);
+
+} // namespace audio_manager
+
+#endif // AUDIO_DECODER_H_
@@ -7,6 +7,20 @@ namespace audio_manager {
     /*** Constructor ***/
     AudioManager::AudioManager(void) {
         initialized_ = 0;
+        running_ = false;
+        voices_reserved_ = 0;
+        listener_x_ = listener_y_ = listener_z_ = 0.0f;
+        cull_radius_ = DEFAULT_CULL_RADIUS;
+
+        commands_executed_ = 0;
+        sound_count_ = 0;
+        commands_submitted_ = 0;
+        dropped_commands_ = 0;
+        for (int i = 0; i < MAX_SOUNDS; i++) {
+            playing_until_[i] = 0.0;
+            request_sequence_[i] = 0;
+            request_playing_[i] = false;
+        }
     }
 
 
@@ -49,8 +63,32 @@ namespace audio_manager {
             /* Initialize the Alut library */
             alutInitWithoutContext(NULL, NULL);
 
+            /* Positional sounds fade out linearly and reach silence exactly at the cull radius */
+            alDistanceModel(AL_LINEAR_DISTANCE_CLAMPED);
+
+            /* Create the voice pool up front, stop early if the device runs out of sources */
+            for (int i = 0; i < VOICE_POOL_SIZE; i++) {
+                Voice voice;
+                alGenSources((ALuint)1, &voice.source);
+                if (alGetError() != AL_NO_ERROR) {
+                    break;
+                }
+                voice.sound = -1;
+                voice.start_time = 0.0;
+                voice.end_time = 0.0;
+                voice.active = false;
+                alSourcef(voice.source, AL_REFERENCE_DISTANCE, DEFAULT_REFERENCE_DISTANCE);
+                alSourcef(voice.source, AL_MAX_DISTANCE, DEFAULT_CULL_RADIUS);
+                voice_.push_back(voice);
+            }
+            voices_reserved_ = 0;
+
             /* Remember that we initialized the audio system */
             initialized_ = 1;
+
+            /* Start the audio thread, from here on playback goes through the command queue */
+            running_ = true;
+            audio_thread_ = std::thread(&AudioManager::AudioLoop, this);
         }
     }
 
@@ -61,11 +99,44 @@ namespace audio_manager {
         if (initialized_) {
             ALCdevice *device;
 
+            /* Stop the audio thread before its sources go away, anything still queued is dropped */
+            running_ = false;
+            if (audio_thread_.joinable()) {
+                audio_thread_.join();
+            }
+
+            /* Unfinished decodes are waited on and thrown away */
+            pending_.clear();
+            decode_cache_.clear();
+
             for (int i = 0; i < buffer_.size(); i++) {
-                alDeleteSources(1, &source_[i]);
-                alDeleteBuffers(1, &buffer_[i]);
+                if (stream_[i]) {
+                    alSourceStop(source_[i]);
+                    alSourcei(source_[i], AL_BUFFER, 0);
+                    alDeleteSources(1, &source_[i]);
+                    alDeleteBuffers(STREAM_BUFFER_COUNT, stream_[i]->buffers);
+                    delete stream_[i]->decoder;
+                    delete stream_[i];
+                }
+                else if (buffer_[i] && sound_[i].shares_buffer < 0) {
+                    alDeleteBuffers(1, &buffer_[i]);
+                }
             }
 
+            /* Pool sources get deleted after the buffers bound to them are gone */
+            for (int i = 0; i < voice_.size(); i++) {
+                alSourceStop(voice_[i].source);
+                alSourcei(voice_[i].source, AL_BUFFER, 0);
+                alDeleteSources(1, &voice_[i].source);
+            }
+            buffer_.clear();
+            source_.clear();
+            stream_.clear();
+            sound_.clear();
+            voice_.clear();
+            voices_reserved_ = 0;
+            sound_count_ = 0;
+
             device = alcGetContextsDevice(context_);
             alcMakeContextCurrent(NULL);
             alcDestroyContext(context_);
@@ -78,82 +149,156 @@ namespace audio_manager {
 
 
     /*** Add a sound to the buffer so it may be played later ***/
-    int AudioManager::AddSound(const char *filename) {
+    int AudioManager::AddSound(const char *filename, int polyphony, int priority, bool positional) {
 
-        ALuint buffer;
-        ALuint source;
+        std::lock_guard<std::mutex> lock(audio_mutex_);
 
-        /* Load data from wav file with Alut library */
-        buffer = alutCreateBufferFromFile(filename);
-        if (!buffer){
-            throw(AudioManagerException(std::string("Failed to load wav file")));
+        /* Make sure the pool can hold this sound before loading anything */
+        if (buffer_.size() >= MAX_SOUNDS) {
+            throw(AudioManagerException(std::string("Too many sounds")));
+        }
+        polyphony = std::max(1, polyphony);
+        if (voices_reserved_ + polyphony > (int)voice_.size()) {
+            throw(AudioManagerException(std::string("Voice pool exhausted")));
         }
-        CheckForErrors("Failed to load wav file");
+
+        SoundInfo info;
+        info.first_voice = voices_reserved_;
+        info.polyphony = polyphony;
+        info.priority = priority;
+        info.shares_buffer = -1;
+        info.duration = 0.0;
+        info.looping = false;
+        info.loaded = false;
+
+        /* Positional sounds get a mono copy, so they are cached separately */
+        int index = buffer_.size();
+        std::string key = std::string(filename) + (positional ? "#mono" : "");
+        std::map<std::string, int>::iterator cached = decode_cache_.find(key);
+        if (cached != decode_cache_.end()) {
+            info.shares_buffer = cached->second;
+        }
+        else {
+            /* Opening reads the header, so missing or broken files still throw here */
+            AudioDecoder* decoder = AudioDecoder::Open(filename);
+            pending_[index] = std::async(std::launch::async, DecodeSound, decoder, positional);
+            decode_cache_[key] = index;
+        }
+
+        /* Reserve the voices now, the buffer is bound once the samples arrive */
+        for (int i = info.first_voice; i < info.first_voice + polyphony; i++) {
+            voice_[i].sound = index;
+        }
+        voices_reserved_ += polyphony;
 
         /* Keep track of buffers created */
-        buffer_.push_back(buffer);
+        buffer_.push_back(0);
+        source_.push_back(0);
+        sound_.push_back(info);
+
+        /* Fully loaded sounds have no streaming state */
+        stream_.push_back(NULL);
+        sound_count_ = buffer_.size();
+
+        /* Return index of last added buffer */
+        return buffer_.size()-1;
+    }
+
+
+    /*** Add a sound that is streamed from disk while it plays ***/
+    int AudioManager::AddStream(const char *filename) {
+
+        /* OpenAL's error state is shared with the audio thread, keep it out while loading */
+        std::lock_guard<std::mutex> lock(audio_mutex_);
+        if (buffer_.size() >= MAX_SOUNDS) {
+            throw(AudioManagerException(std::string("Too many sounds")));
+        }
 
-        /* Create a source for this buffer */
+        /* Only parse the header now, the samples are decoded on demand */
+        StreamingSound* stream = new StreamingSound();
+        stream->looping = false;
+        stream->playing = false;
+        try {
+            stream->decoder = AudioDecoder::Open(filename);
+        }
+        catch (AudioManagerException&) {
+            delete stream;
+            throw;
+        }
+
+        /* Create the small ring of buffers that gets queued on the source */
+        alGenBuffers(STREAM_BUFFER_COUNT, stream->buffers);
+        CheckForErrors("Failed to generate stream buffers");
+
+        ALuint source;
         alGenSources((ALuint)1, &source);
         CheckForErrors("Failed to generate source");
 
-        /* Keep track of sources created */
+        /* Streams are music and ambience, they stay on the listener wherever it goes */
+        alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+        CheckForErrors("Failed to make source relative");
+
+        /* Streams share the same index space as regular sounds, but have their own source */
+        SoundInfo info;
+        info.first_voice = -1;
+        info.polyphony = 0;
+        info.priority = 0;
+        info.shares_buffer = -1;
+        info.duration = 0.0;
+        info.looping = false;
+        info.loaded = true;
+
+        buffer_.push_back(0);
         source_.push_back(source);
+        sound_.push_back(info);
+        stream_.push_back(stream);
+        sound_count_ = buffer_.size();
 
-        /* Return index of last added buffer */
         return buffer_.size()-1;
     }
 
 
     /*** Play a sound by index ***/
     void AudioManager::PlaySound(int index) {
-        // Ensure the source is stopped before playing
-        ALint source_state;
-        alGetSourcei(source_[index], AL_SOURCE_STATE, &source_state);
-        if (source_state == AL_PLAYING || source_state == AL_PAUSED) {
-            alSourceStop(source_[index]);
-            CheckForErrors("Failed to stop source");
-        }
+        Submit(PLAY_SOUND, index, 0.0f, 0.0f, 0.0f, false);
+    }
 
-        // Associate buffer to source
-        alSourcei(source_[index], AL_BUFFER, buffer_[index]);
-        CheckForErrors("Failed to bind buffer");
 
-        // Play source
-        alSourcePlay(source_[index]);
-        CheckForErrors("Failed to play source");
+    /*** Play a sound by index at a world position, unless it's too far away to hear ***/
+    void AudioManager::PlaySoundAt(int index, double x, double y, double z) {
+        float dx = (float)x - listener_x_;
+        float dy = (float)y - listener_y_;
+        float dz = (float)z - listener_z_;
+        if (dx*dx + dy*dy + dz*dz > cull_radius_*cull_radius_) {
+            return;
+        }
+        Submit(PLAY_SOUND_AT, index, (float)x, (float)y, (float)z, false);
     }
 
 
     /*** Stop a sound by index ***/
     void AudioManager::StopSound(int index) {
-
-        // Stop source
-        ALint source_state;
-        alGetSourcei(source_[index], AL_SOURCE_STATE, &source_state);
-        if (source_state == AL_PLAYING || source_state == AL_PAUSED) {
-            alSourceStop(source_[index]);
-            CheckForErrors("Failed to stop source");
-        }
-
-        // Associate buffer to source
-        alSourcei(source_[index], AL_BUFFER, buffer_[index]);
-        CheckForErrors("Failed to bind buffer");
+        Submit(STOP_SOUND, index, 0.0f, 0.0f, 0.0f, false);
     }
 
 
-    /*** Check if the sound at the param index is currently playing ***/
+    /*** Check if the sound at the param index is currently playing, without touching anything the audio thread owns ***/
     bool AudioManager::SoundIsPlaying(int index) {
-        ALint source_state;
-        alGetSourcei(source_[index], AL_SOURCE_STATE, &source_state);
-        CheckForErrors("Failed to get source state");
-        return (source_state == AL_PLAYING);
+
+        // A play or stop the audio thread hasn't got to yet is what the caller expects to hear
+        if (request_sequence_[index] > commands_executed_.load(std::memory_order_acquire)) {
+            return request_playing_[index];
+        }
+
+        // Otherwise go by what it published, voices end on their own so it's kept as an end time
+        return Now() < playing_until_[index].load(std::memory_order_acquire);
     }
 
 
     /*** Check if there is any sound playing ***/
     bool AudioManager::AnySoundIsPlaying(void) {
-        for (int i = 0; i < source_.size(); i++) {
+        int count = sound_count_;
+        for (int i = 0; i < count; i++) {
             if (SoundIsPlaying(i)){
                 return true;
             }
@@ -183,28 +328,34 @@ namespace audio_manager {
     }
 
 
+    /*** Error checking for the audio thread, logs instead of throwing ***/
+    void AudioManager::ReportErrors(const char *msg) {
+        ALCenum error;
+        error = alGetError();
+        if (error != AL_NO_ERROR) {
+            std::cerr << msg << " (OpenAL error " << error << ")" << std::endl;
+        }
+    }
+
+
     /*** Set coordinates for where the listener is ***/
     void AudioManager::SetListenerPosition(double x, double y, double z) {
-        alListener3f(AL_POSITION, x, y, z);
-        CheckForErrors("Failed to set listener position");
+        listener_x_ = (float)x;
+        listener_y_ = (float)y;
+        listener_z_ = (float)z;
+        Submit(SET_LISTENER_POSITION, -1, (float)x, (float)y, (float)z, false);
     }
 
 
     /*** Set coordinates for where a sound should be played ***/
     void AudioManager::SetSoundPosition(int index, double x, double y, double z) {
-        alSource3f(source_[index], AL_POSITION, x, y, z);
-        CheckForErrors("Failed to set sound position");
+        Submit(SET_SOUND_POSITION, index, (float)x, (float)y, (float)z, false);
     }
 
 
     /*** Allows a sound to repeat over and over again (e.g. bg_music) ***/
     void AudioManager::SetLoop(int index, bool loop) {
-        if (loop) {
-            alSourcei(source_[index], AL_LOOPING, AL_TRUE);
-        } else {
-            alSourcei(source_[index], AL_LOOPING, AL_FALSE);
-        }
-        CheckForErrors("Failed to set sound looping flag");
+        Submit(SET_LOOP, index, 0.0f, 0.0f, 0.0f, loop);
     }
 
 
@@ -213,8 +364,457 @@ namespace audio_manager {
         // Clamp gain between 0.0 and 1.0
         gain = std::max(0.0f, std::min(1.0f, gain));
 
-        alListenerf(AL_GAIN, gain);
-        CheckForErrors("Failed to set master gain");
+        Submit(SET_MASTER_GAIN, -1, gain, 0.0f, 0.0f, false);
+    }
+
+
+    /*** Set the distances positional sounds fade between, and where they stop being played ***/
+    void AudioManager::SetAttenuation(float reference_distance, float cull_radius) {
+        cull_radius_ = std::max(reference_distance, cull_radius);
+        Submit(SET_ATTENUATION, -1, reference_distance, cull_radius_, 0.0f, false);
+    }
+
+
+    /*** Queue a command for the audio thread, this is all a playback call costs the game thread ***/
+    void AudioManager::Submit(AudioCommandType type, int index, float x, float y, float z, bool flag) {
+        AudioCommand command;
+        command.type = type;
+        command.index = index;
+        command.x = x;
+        command.y = y;
+        command.z = z;
+        command.flag = flag;
+
+        // A full queue means the audio thread is far behind, losing a sound beats stalling a frame
+        if (!commands_.Push(command)) {
+            dropped_commands_++;
+            return;
+        }
+        commands_submitted_++;
+
+        // Remember where plays and stops sit in the queue, until they're run they decide SoundIsPlaying
+        if (type == PLAY_SOUND || type == PLAY_SOUND_AT || type == STOP_SOUND) {
+            request_sequence_[index] = commands_submitted_;
+            request_playing_[index] = type != STOP_SOUND;
+        }
+    }
+
+
+    /*** Hand over the dropped command count and start counting again ***/
+    int AudioManager::TakeDroppedCommands(void) {
+        int dropped = dropped_commands_;
+        dropped_commands_ = 0;
+        return dropped;
+    }
+
+
+    /*** Run one queued command on the audio thread ***/
+    void AudioManager::ExecuteCommand(const AudioCommand& command) {
+        switch (command.type) {
+            case PLAY_SOUND:
+                PlayVoice(command.index, false, 0.0f, 0.0f, 0.0f);
+                break;
+            case PLAY_SOUND_AT:
+                PlayVoice(command.index, true, command.x, command.y, command.z);
+                break;
+            case STOP_SOUND:
+                StopVoices(command.index);
+                break;
+            case SET_SOUND_POSITION:
+                PositionVoices(command.index, command.x, command.y, command.z);
+                break;
+            case SET_LOOP:
+                LoopVoices(command.index, command.flag);
+                break;
+            case SET_LISTENER_POSITION:
+                alListener3f(AL_POSITION, command.x, command.y, command.z);
+                break;
+            case SET_MASTER_GAIN:
+                alListenerf(AL_GAIN, command.x);
+                break;
+            case SET_ATTENUATION:
+                AttenuateVoices(command.x, command.y);
+                break;
+        }
+
+        // Publish the sound's new state before the command counts as run
+        if (command.index >= 0) {
+            PublishState(command.index);
+        }
+        commands_executed_.fetch_add(1, std::memory_order_release);
+    }
+
+
+    /*** Latest end time of the sound's voices, or infinity for anything that plays until stopped ***/
+    void AudioManager::PublishState(int index) {
+        double until = 0.0;
+        if (stream_[index]) {
+            until = stream_[index]->playing ? std::numeric_limits<double>::infinity() : 0.0;
+        }
+        else {
+            SoundInfo& info = sound_[index];
+            for (int i = info.first_voice; i < info.first_voice + info.polyphony; i++) {
+                if (voice_[i].active) {
+                    until = std::max(until, info.looping ? std::numeric_limits<double>::infinity() : voice_[i].end_time);
+                }
+            }
+        }
+        playing_until_[index].store(until, std::memory_order_release);
+    }
+
+
+    /*** Start a sound on a voice from the pool ***/
+    void AudioManager::PlayVoice(int index, bool positional, float x, float y, float z) {
+
+        // Streamed sounds restart from the top of the file, they are never positional
+        if (stream_[index]) {
+            StartStream(stream_[index], source_[index]);
+            return;
+        }
+
+        // Only the first play of a sound can get here before its decode has been picked up
+        if (!sound_[index].loaded) {
+            FinishLoad(index);
+        }
+
+        SoundInfo& info = sound_[index];
+        double now = Now();
+
+        // Prefer a voice of this sound that has finished, otherwise restart its oldest one
+        Voice* voice = NULL;
+        for (int i = info.first_voice; i < info.first_voice + info.polyphony; i++) {
+            if (!VoiceIsActive(voice_[i], now)) {
+                voice = &voice_[i];
+                break;
+            }
+            if (!voice || voice_[i].start_time < voice->start_time) {
+                voice = &voice_[i];
+            }
+        }
+
+        // A new voice is about to start, make room if too many are already playing
+        if (!VoiceIsActive(*voice, now)) {
+            int active = 0;
+            for (int i = 0; i < voices_reserved_; i++) {
+                if (VoiceIsActive(voice_[i], now)) {
+                    active++;
+                }
+            }
+            if (active >= MAX_ACTIVE_VOICES && !StealVoice(info.priority, now)) {
+                // everything playing is more important, drop this sound
+                return;
+            }
+        }
+
+        // Voices are shared between positional and flat plays, flat ones sit on the listener
+        if (positional) {
+            alSourcei(voice->source, AL_SOURCE_RELATIVE, AL_FALSE);
+            alSource3f(voice->source, AL_POSITION, x, y, z);
+        }
+        else {
+            alSourcei(voice->source, AL_SOURCE_RELATIVE, AL_TRUE);
+            alSource3f(voice->source, AL_POSITION, 0.0f, 0.0f, 0.0f);
+        }
+
+        // Playing an already playing source restarts it
+        alSourcePlay(voice->source);
+
+        voice->start_time = now;
+        voice->end_time = now + info.duration;
+        voice->active = true;
+    }
+
+
+    /*** Stop every voice of a sound ***/
+    void AudioManager::StopVoices(int index) {
+
+        // Streamed sounds also drop their queued buffers
+        if (stream_[index]) {
+            StopStream(stream_[index], source_[index]);
+            return;
+        }
+
+        // Stop every voice of the sound that is still going, the buffers stay bound
+        SoundInfo& info = sound_[index];
+        double now = Now();
+        for (int i = info.first_voice; i < info.first_voice + info.polyphony; i++) {
+            if (VoiceIsActive(voice_[i], now)) {
+                alSourceStop(voice_[i].source);
+            }
+            voice_[i].active = false;
+        }
+    }
+
+
+    /*** Move every voice of a sound ***/
+    void AudioManager::PositionVoices(int index, float x, float y, float z) {
+        if (stream_[index]) {
+            alSource3f(source_[index], AL_POSITION, x, y, z);
+        }
+        else {
+            SoundInfo& info = sound_[index];
+            for (int i = info.first_voice; i < info.first_voice + info.polyphony; i++) {
+                alSource3f(voice_[i].source, AL_POSITION, x, y, z);
+            }
+        }
+    }
+
+
+    /*** Set the looping flag on every voice of a sound ***/
+    void AudioManager::LoopVoices(int index, bool loop) {
+
+        // Streams loop by rewinding the file, AL_LOOPING would only repeat the queued buffers
+        if (stream_[index]) {
+            stream_[index]->looping = loop;
+            return;
+        }
+
+        SoundInfo& info = sound_[index];
+        info.looping = loop;
+        for (int i = info.first_voice; i < info.first_voice + info.polyphony; i++) {
+            if (loop) {
+                alSourcei(voice_[i].source, AL_LOOPING, AL_TRUE);
+            } else {
+                alSourcei(voice_[i].source, AL_LOOPING, AL_FALSE);
+            }
+        }
+    }
+
+
+    /*** Apply new distance settings to every voice in the pool ***/
+    void AudioManager::AttenuateVoices(float reference_distance, float cull_radius) {
+        for (int i = 0; i < voice_.size(); i++) {
+            alSourcef(voice_[i].source, AL_REFERENCE_DISTANCE, reference_distance);
+            alSourcef(voice_[i].source, AL_MAX_DISTANCE, cull_radius);
+        }
+    }
+
+
+    /*** Upload a decoded sound and bind it to its voices, sounds sharing a file reuse the first one's buffer ***/
+    void AudioManager::FinishLoad(int index) {
+        SoundInfo& info = sound_[index];
+
+        if (info.shares_buffer >= 0) {
+            SoundInfo& original = sound_[info.shares_buffer];
+            if (!original.loaded) {
+                FinishLoad(info.shares_buffer);
+            }
+            buffer_[index] = buffer_[info.shares_buffer];
+            info.duration = original.duration;
+        }
+        else {
+            std::future<DecodedSound> decode = std::move(pending_[index]);
+            pending_.erase(index);
+
+            try {
+                DecodedSound sound = decode.get();
+
+                ALuint buffer;
+                alGenBuffers(1, &buffer);
+                alBufferData(buffer, sound.format, sound.samples.data(), sound.samples.size(), sound.frequency);
+                buffer_[index] = buffer;
+
+                // Work out the length of the sound once, so playback never has to ask OpenAL
+                info.duration = (double)sound.samples.size() / (BytesPerFrame(sound.format) * sound.frequency);
+            }
+            catch (std::exception& e) {
+                // a bad file leaves the sound silent rather than taking the audio thread down
+                std::cerr << e.what() << std::endl;
+            }
+        }
+
+        // Bind the buffer to its voices for good, a play is then just alSourcePlay
+        for (int i = info.first_voice; i < info.first_voice + info.polyphony; i++) {
+            alSourcei(voice_[i].source, AL_BUFFER, buffer_[index]);
+        }
+        info.loaded = true;
+    }
+
+
+    /*** Seconds on a monotonic clock, used to age voices without querying OpenAL ***/
+    double AudioManager::Now(void) const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+
+    /*** Check if a voice is still playing, looping voices play until stopped ***/
+    bool AudioManager::VoiceIsActive(const Voice& voice, double now) const {
+        if (!voice.active) {
+            return false;
+        }
+        return sound_[voice.sound].looping || now < voice.end_time;
+    }
+
+
+    /*** Stop the least important voice (lowest priority, then oldest), returns NULL if none qualify ***/
+    Voice* AudioManager::StealVoice(int priority, double now) {
+        Voice* victim = NULL;
+        int victim_priority = 0;
+
+        for (int i = 0; i < voices_reserved_; i++) {
+            Voice& voice = voice_[i];
+            if (!VoiceIsActive(voice, now)) {
+                continue;
+            }
+
+            // only voices that matter no more than the new sound can be stolen
+            int voice_priority = sound_[voice.sound].priority;
+            if (voice_priority > priority) {
+                continue;
+            }
+
+            if (!victim || voice_priority < victim_priority ||
+                (voice_priority == victim_priority && voice.start_time < victim->start_time)) {
+                victim = &voice;
+                victim_priority = voice_priority;
+            }
+        }
+
+        if (victim) {
+            alSourceStop(victim->source);
+            victim->active = false;
+            PublishState(victim->sound);
+        }
+        return victim;
+    }
+
+
+    /*** Decode the next chunk of a stream into a buffer, returns false once there's nothing left ***/
+    bool AudioManager::FillStreamBuffer(StreamingSound* stream, ALuint buffer) {
+
+        // Scratch space is shared, which is safe since callers hold the audio mutex
+        static char chunk[STREAM_BUFFER_SIZE];
+        unsigned int filled = 0;
+        bool rewound = false;
+
+        while (filled < STREAM_BUFFER_SIZE) {
+            unsigned int got = stream->decoder->Read(chunk + filled, STREAM_BUFFER_SIZE - filled);
+            filled += got;
+
+            // Reached the end of the samples, rewind if looping (once, in case the file is empty)
+            if (got == 0) {
+                if (!stream->looping || rewound) {
+                    break;
+                }
+                stream->decoder->Rewind();
+                rewound = true;
+            }
+            else {
+                rewound = false;
+            }
+        }
+
+        if (filled == 0) {
+            return false;
+        }
+
+        alBufferData(buffer, stream->decoder->GetFormat(), chunk, filled, stream->decoder->GetFrequency());
+        return true;
+    }
+
+
+    /*** Rewind a stream and queue its first buffers onto the source ***/
+    void AudioManager::StartStream(StreamingSound* stream, ALuint source) {
+        StopStream(stream, source);
+        stream->decoder->Rewind();
+
+        // Prime the queue before playing so the source doesn't starve immediately
+        int queued = 0;
+        for (int i = 0; i < STREAM_BUFFER_COUNT; i++) {
+            if (!FillStreamBuffer(stream, stream->buffers[i])) {
+                break;
+            }
+            queued++;
+        }
+        alSourceQueueBuffers(source, queued, stream->buffers);
+        alSourcePlay(source);
+
+        stream->playing = queued > 0;
+    }
+
+
+    /*** Stop a stream and take all of its buffers off the source ***/
+    void AudioManager::StopStream(StreamingSound* stream, ALuint source) {
+        alSourceStop(source);
+
+        // Unqueue everything, stopped sources mark all buffers as processed
+        alSourcei(source, AL_BUFFER, 0);
+
+        stream->playing = false;
+    }
+
+
+    /*** Refill the buffers the source has finished with ***/
+    void AudioManager::UpdateStream(StreamingSound* stream, ALuint source) {
+        ALint processed = 0;
+        alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+
+        bool more_data = true;
+        while (processed-- > 0) {
+            ALuint buffer;
+            alSourceUnqueueBuffers(source, 1, &buffer);
+            if (more_data && FillStreamBuffer(stream, buffer)) {
+                alSourceQueueBuffers(source, 1, &buffer);
+            }
+            else {
+                more_data = false;
+            }
+        }
+
+        // The source stops by itself if it ran dry (e.g. a hitch on the main thread)
+        ALint state, queued;
+        alGetSourcei(source, AL_SOURCE_STATE, &state);
+        alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+        if (state != AL_PLAYING) {
+            if (queued > 0) {
+                alSourcePlay(source);
+            }
+            else {
+                stream->playing = false;
+            }
+        }
+    }
+
+
+    /*** Audio thread, runs queued commands then keeps every playing stream topped up ***/
+    void AudioManager::AudioLoop(void) {
+        AudioCommand command;
+
+        while (running_) {
+            {
+                std::lock_guard<std::mutex> lock(audio_mutex_);
+
+                // Errors are only checked once per batch, one alGetError per call adds up
+                while (commands_.Pop(command)) {
+                    ExecuteCommand(command);
+                }
+                ReportErrors("Failed to run audio commands");
+
+                // Upload any sounds the loader threads have finished with
+                std::map<int, std::future<DecodedSound> >::iterator it = pending_.begin();
+                while (it != pending_.end()) {
+                    int index = (it++)->first;
+                    if (pending_[index].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                        FinishLoad(index);
+                    }
+                }
+                for (int i = 0; i < sound_.size(); i++) {
+                    if (!sound_[i].loaded && sound_[i].shares_buffer >= 0 && sound_[sound_[i].shares_buffer].loaded) {
+                        FinishLoad(i);
+                    }
+                }
+                ReportErrors("Failed to upload sounds");
+
+                for (int i = 0; i < stream_.size(); i++) {
+                    if (stream_[i] && stream_[i]->playing) {
+                        UpdateStream(stream_[i], source_[i]);
+                        PublishState(i);
+                    }
+                }
+                ReportErrors("Failed to update streams");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_UPDATE_MS));
+        }
     }
 
 } // namespace audio_manager;
@@ -11,12 +11,44 @@
 #include <AL/alc.h>
 #include <AL/alut.h>
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
+#include <fstream>
+#include <string>
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <map>
+
+#include "audio_command_queue.h"
+#include "audio_decoder.h"
 
 namespace audio_manager {
 
+    // Streaming constants, a stream keeps STREAM_BUFFER_COUNT buffers of STREAM_BUFFER_SIZE bytes queued
+    const int STREAM_BUFFER_COUNT = 4;
+    const int STREAM_BUFFER_SIZE = 32768;
+
+    // How often the audio thread wakes up to run queued commands and feed streams
+    const int AUDIO_UPDATE_MS = 2;
+
+    // Voice pool constants, sources are created once and shared out between sounds on load
+    const int VOICE_POOL_SIZE = 48;
+    const int MAX_ACTIVE_VOICES = 24;
+
+    // Most sounds and streams that can be added, the playing state of each is published in a fixed array
+    const int MAX_SOUNDS = 64;
+
+    // Default attenuation, positional sounds are full volume within the reference distance and
+    // fade out linearly until the cull radius, past which they aren't played at all
+    const float DEFAULT_REFERENCE_DISTANCE = 1.0f;
+    const float DEFAULT_CULL_RADIUS = 100.0f;
+
     // Audio manager exception type
     class AudioManagerException: public std::exception
     {
@@ -28,7 +60,41 @@ namespace audio_manager {
             virtual const char* what() const throw() { return message_.c_str(); };
     };
 
-    // A simple audio manager implemented with OpenAl
+    // State of a sound that is decoded in chunks instead of being loaded into a single buffer
+    struct StreamingSound {
+        AudioDecoder* decoder;
+        ALuint buffers[STREAM_BUFFER_COUNT];
+        bool looping;
+        bool playing;
+    };
+
+
+    // One OpenAL source from the voice pool, its sound's buffer stays bound to it permanently
+    struct Voice {
+        ALuint source;
+        int sound;
+        double start_time;
+        double end_time;
+        bool active;
+    };
+
+    // Playback settings of a fully loaded sound, owns voices [first_voice, first_voice + polyphony).
+    // shares_buffer is the index of an earlier sound with the same file, or -1
+    struct SoundInfo {
+        int first_voice;
+        int polyphony;
+        int priority;
+        int shares_buffer;
+        double duration;
+        bool looping;
+        bool loaded;
+    };
+
+
+    /* A simple audio manager implemented with OpenAl. Loading happens on
+     * the calling thread, but playback calls only queue a command for the
+     * audio thread, so they never wait on the driver. All playback calls
+     * must come from the same (game) thread */
     class AudioManager {
         public:
             AudioManager(void);
@@ -41,54 +107,157 @@ namespace audio_manager {
             // Shut down the audio system
             void ShutDown(void);
 
-            /* Load a wav audio file and add its contents to a buffer.
-             * The buffer can then be played multiple times with
+            /* Load a wav (or ogg) audio file and add its contents to a
+             * buffer. The buffer can then be played multiple times with
              * PlaySound. AddSound returns the index of the file in
              * the list of buffers. This index should be passed to
-             * PlaySound to play the respective file */
-            int AddSound(const char *filename);
+             * PlaySound to play the respective file. Only the header is
+             * read here, decoding happens on a loader thread and a file
+             * that was already added is decoded only once.
+             * polyphony is how many copies of the sound may overlap, and
+             * priority decides which voices get stolen first once too
+             * many sounds are playing (lower is stolen first).
+             * positional sounds are mixed down to mono on load, since
+             * OpenAL only places mono sounds in space */
+            int AddSound(const char *filename, int polyphony = 1, int priority = 0, bool positional = false);
 
-            // Play buffer with specific index
+            /* Open a wav (or ogg) audio file for streaming, only the header is read
+             * here. While playing, the file is decoded in small chunks on a
+             * background thread and queued onto the source, so long tracks
+             * (e.g. music) never sit fully in memory. Returns an index that
+             * is used exactly like the one returned by AddSound */
+            int AddStream(const char *filename);
+
+            /* Play buffer with specific index. Uses a free voice of the
+             * sound if there is one, otherwise restarts its oldest voice.
+             * Queued, the sound starts within AUDIO_UPDATE_MS */
             void PlaySound(int index);
 
-            // Stop a sound
+            /* Play buffer with specific index at a point in the world.
+             * Sounds further than the cull radius from the listener are
+             * skipped before anything is queued */
+            void PlaySoundAt(int index, double x, double y, double z);
+
+            // Stop a sound, queued
             void StopSound(int index);
 
-            // Check if the buffer with the given index is being played
+            /* Check if the buffer with the given index is being played.
+             * Never waits on the audio thread, it reads what that thread last
+             * published, unless a play or stop it hasn't run yet is queued */
             bool SoundIsPlaying(int index);
 
             // Check if any buffer is being played
             bool AnySoundIsPlaying(void);
 
+            // Commands dropped because the queue was full since the last call, for the profiler
+            int TakeDroppedCommands(void);
+
             // List all audio devices available to standard output
             void ListAudioDevices(void);
 
-            // Set spatial position of listener
+            // Set spatial position of listener, queued
             void SetListenerPosition(double x, double y, double z);
 
             /* Set spatial position of a sound. Same index as used for
-             * PlaySound */
+             * PlaySound, queued */
             void SetSoundPosition(int index, double x, double y, double z);
 
-            // Set whether sound should be looped
+            // Set whether sound should be looped, queued
             void SetLoop(int index, bool loop);
 
-            // Set a universal volume level
+            // Set a universal volume level, queued
             void SetMasterGain(float gain);
 
+            /* Set how positional sounds fade with distance, full volume up to
+             * reference_distance, silent (and culled) from cull_radius on */
+            void SetAttenuation(float reference_distance, float cull_radius);
+
         private:
             // Audio context used by OpenAl
             ALCcontext *context_;
             // All the buffers we can play
             std::vector<ALuint> buffer_;
-            // One source for each buffer
+            // Source of each streamed sound, 0 for sounds played through the voice pool
             std::vector<ALuint> source_;
+            // Playback settings for each index
+            std::vector<SoundInfo> sound_;
+            // The voice pool, and how much of it has been handed out to sounds
+            std::vector<Voice> voice_;
+            int voices_reserved_;
+            // Streaming state for each index, NULL if the sound is fully loaded
+            std::vector<StreamingSound*> stream_;
+
+            // Decodes still running on loader threads, by index
+            std::map<int, std::future<DecodedSound> > pending_;
+            // First index loaded for each file (and mono flag), so repeats reuse its buffer
+            std::map<std::string, int> decode_cache_;
+
+            // Background thread that runs queued commands and keeps the streaming sources fed,
+            // the mutex guards everything above against sounds being added while it runs
+            std::thread audio_thread_;
+            std::mutex audio_mutex_;
+            std::atomic<bool> running_;
+
+            // Commands from the game thread waiting for the audio thread
+            AudioCommandQueue commands_;
+
+            // Published by the audio thread after each command or stream update: when each sound
+            // stops playing on the steady clock (infinity while looping or streaming, 0 if stopped),
+            // and how many commands it has run
+            std::atomic<double> playing_until_[MAX_SOUNDS];
+            std::atomic<size_t> commands_executed_;
+            std::atomic<int> sound_count_;
+
+            // Game thread only, commands queued so far, the queue position of each sound's last play
+            // or stop and whether it was a play, and commands lost to a full queue
+            size_t commands_submitted_;
+            size_t request_sequence_[MAX_SOUNDS];
+            bool request_playing_[MAX_SOUNDS];
+            int dropped_commands_;
+
+            // Game thread copies of the listener position and cull radius, used to cull plays
+            float listener_x_, listener_y_, listener_z_;
+            float cull_radius_;
 
             // Keep track if we already initialized the audio manager
             int initialized_;
 
             // Auxiliary method to handle OpenAl errors
             void CheckForErrors(const char *msg);
+
+            // Error check for the audio thread, which has nowhere to throw to so it reports instead
+            void ReportErrors(const char *msg);
+
+            // Hand a command to the audio thread, drops it if the queue is full rather than block
+            void Submit(AudioCommandType type, int index, float x, float y, float z, bool flag);
+
+            // Audio thread side of the queued calls, the audio mutex must be held when calling these
+            void ExecuteCommand(const AudioCommand& command);
+            void PlayVoice(int index, bool positional, float x, float y, float z);
+            void StopVoices(int index);
+            void PositionVoices(int index, float x, float y, float z);
+            void LoopVoices(int index, bool loop);
+            void AttenuateVoices(float reference_distance, float cull_radius);
+
+            // Work out a sound's playing state and publish it for SoundIsPlaying
+            void PublishState(int index);
+
+            // Hand a sound's decoded samples to OpenAL, waits for its decode if needed
+            void FinishLoad(int index);
+
+            // Voice pool helpers
+            double Now(void) const;
+            bool VoiceIsActive(const Voice& voice, double now) const;
+            Voice* StealVoice(int priority, double now);
+
+            // Streaming helpers, the audio mutex must be held when calling these
+            bool FillStreamBuffer(StreamingSound* stream, ALuint buffer);
+            void StartStream(StreamingSound* stream, ALuint source);
+            void StopStream(StreamingSound* stream, ALuint source);
+            void UpdateStream(StreamingSound* stream, ALuint source);
+
+            // Body of the audio thread
+            void AudioLoop(void);
     }; 
 
 } // namespace audio_manager;
@@ -14,10 +14,11 @@ namespace game {
         // initialize defaults
         point_cost = 100;
         name_and_cost = "";
-        scale_ = glm::vec2(1.8f);
+        Scale() = glm::vec2(1.8f);
 
-        // create the icon
-        icon = new GameObject(position, geom, shader, icon_tex);
+        // create the icon, from a copy of the stored position since adding the ring may have moved what position points at
+        glm::vec3 icon_pos = GetPosition();
+        icon = new GameObject(icon_pos, geom, shader, icon_tex);
     }
 
     
@@ -29,7 +30,7 @@ namespace game {
 
     /*** Overriden Update function, makes the border spin (cool visuals) ***/
     void BuyableItem::Update(double delta_time) {
-        angle_ += delta_time * 0.6f;
+        Angle() += delta_time * 0.6f;
     }
 
 }
\ No newline at end of file
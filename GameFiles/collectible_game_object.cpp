@@ -13,23 +13,21 @@ namespace game {
 		collected = false;
 
 		// start erase_timer, as collectibles should auto delete after a period of time
-		erase_timer_.Start(COLLECTIBLE_DURATION);
-	}
-
+		SetEraseTime(COLLECTIBLE_DURATION);
 
-	/*** Update function for Collectible Objects ***/
-	void CollectibleGameObject::Update(double delta_time) {
-		position_ += velocity_ * COLLECTIBLE_SPEED * static_cast<float>(delta_time);
+		// drifts along its velocity, moved by the store's movement system
+		MoveSpeed() = COLLECTIBLE_SPEED;
 	}
 
 
 	/*** Handle collecting the object ***/
 	void CollectibleGameObject::Collect(void) {
 		collected = true;
-		ghost_ = true;
+		Ghost() = true;
+		MoveSpeed() = 0.0f;
 
 		// override the erase timer so the collectible is erased in 2 seconds
-		erase_timer_.Start(2.0f);
+		SetEraseTime(2.0f);
 	}
 
 } // namespace game
@@ -15,9 +15,6 @@ namespace game {
         CollectibleGameObject(const glm::vec3& position, Geometry* geom, Shader* shader,
                               const GLuint& texture, int pu_id);
 
-        // Overriden update function
-        void Update(double delta_time) override;
-
         // Collect flag helpers
         virtual void Collect(void);
         inline bool IsCollected(void) const { return collected; }
@@ -0,0 +1,74 @@
+// CollisionGrid class definitions
+
+#include <algorithm>
+#include <cmath>
+
+#include "collision_grid.h"
+
+namespace game {
+
+    /*** Constructor, sizes the cell table once ***/
+    CollisionGrid::CollisionGrid(float span, float cell_size)
+        : origin_(-span * 0.5f), half_size_(span * 0.5f), cell_size_(cell_size) {
+        cells_per_side_ = std::max(1, (int)std::ceil(span / cell_size));
+        cell_start_.assign(cells_per_side_ * cells_per_side_ + 1, 0);
+    }
+
+
+    /*** Forget everything inserted last frame, keeps the memory ***/
+    void CollisionGrid::Clear(void) {
+        ids_.clear();
+        cells_.clear();
+        sorted_ids_.clear();
+    }
+
+
+    /*** Move the area the grid covers, cells stay aligned to cell_size so nothing shifts while the center moves within a cell ***/
+    void CollisionGrid::SetCenter(const glm::vec3& center) {
+        origin_.x = std::floor((center.x - half_size_) / cell_size_) * cell_size_;
+        origin_.y = std::floor((center.y - half_size_) / cell_size_) * cell_size_;
+    }
+
+
+    /*** Add an object, it's only visible to queries after Finalize ***/
+    void CollisionGrid::Insert(int id, const glm::vec3& position) {
+        ids_.push_back(id);
+        cells_.push_back(CellY(position.y) * cells_per_side_ + CellX(position.x));
+    }
+
+
+    /*** Group the inserted ids by cell with a counting sort, stable so insertion order is kept ***/
+    void CollisionGrid::Finalize(void) {
+        std::fill(cell_start_.begin(), cell_start_.end(), 0);
+
+        // count per cell, shifted by one so the prefix sum gives each cell's start
+        for (int i = 0; i < cells_.size(); i++) {
+            cell_start_[cells_[i] + 1]++;
+        }
+        for (int c = 1; c < cell_start_.size(); c++) {
+            cell_start_[c] += cell_start_[c - 1];
+        }
+
+        // scatter, using a copy of the starts as write cursors
+        cursor_.assign(cell_start_.begin(), cell_start_.end() - 1);
+        sorted_ids_.resize(ids_.size());
+        for (int i = 0; i < ids_.size(); i++) {
+            sorted_ids_[cursor_[cells_[i]]++] = ids_[i];
+        }
+    }
+
+
+    /*** Column of a world x coordinate ***/
+    int CollisionGrid::CellX(float x) const {
+        int cell = (int)std::floor((x - origin_.x) / cell_size_);
+        return std::min(std::max(cell, 0), cells_per_side_ - 1);
+    }
+
+
+    /*** Row of a world y coordinate ***/
+    int CollisionGrid::CellY(float y) const {
+        int cell = (int)std::floor((y - origin_.y) / cell_size_);
+        return std::min(std::max(cell, 0), cells_per_side_ - 1);
+    }
+
+} // namespace game
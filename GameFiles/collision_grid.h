@@ -0,0 +1,68 @@
+// CollisionGrid class declarations, a uniform grid over the world used as the collision broad-phase
+
+#ifndef COLLISION_GRID_H_
+#define COLLISION_GRID_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game {
+
+    /* Buckets object ids by the cell their position falls in. Rebuilt every
+     * frame: Clear, Insert each object, then Finalize. The grid only spans
+     * the area around its center, so its size doesn't depend on the world's.
+     * Objects outside it share the border cells, which keeps queries correct.
+     * Queries are read-only, so any number of threads can run them at once
+     * after Finalize */
+    class CollisionGrid {
+
+        public:
+            // Constructor, the grid covers a square of side span, centered on the origin until moved
+            CollisionGrid(float span, float cell_size);
+
+            // Building, the center can only move while the grid is empty
+            void Clear(void);
+            void SetCenter(const glm::vec3& center);
+            void Insert(int id, const glm::vec3& position);
+            void Finalize(void);
+
+            /* Call visit(id) for every object in the cells touched by a circle,
+             * cells in row order and ids in insertion order so results are repeatable */
+            template <typename Visitor>
+            void ForEachNear(const glm::vec3& position, float radius, Visitor visit) const {
+                int min_x = CellX(position.x - radius), max_x = CellX(position.x + radius);
+                int min_y = CellY(position.y - radius), max_y = CellY(position.y + radius);
+                for (int y = min_y; y <= max_y; y++) {
+                    for (int x = min_x; x <= max_x; x++) {
+                        int cell = y * cells_per_side_ + x;
+                        for (int i = cell_start_[cell]; i < cell_start_[cell + 1]; i++) {
+                            visit(sorted_ids_[i]);
+                        }
+                    }
+                }
+            }
+
+        private:
+            // Cell coordinates, positions outside the grid land in the border cells
+            int CellX(float x) const;
+            int CellY(float y) const;
+
+            glm::vec2 origin_;  // corner of the grid with the lowest coordinates
+            float half_size_;
+            float cell_size_;
+            int cells_per_side_;
+
+            // Filled by Insert
+            std::vector<int> ids_;
+            std::vector<int> cells_;
+
+            // Filled by Finalize, the ids of cell c are sorted_ids_[cell_start_[c] .. cell_start_[c+1])
+            std::vector<int> cell_start_;
+            std::vector<int> sorted_ids_;
+            std::vector<int> cursor_;
+
+    }; // class CollisionGrid
+
+} // namespace game
+
+#endif // COLLISION_GRID_H_
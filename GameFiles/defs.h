@@ -20,30 +20,90 @@ namespace game {
 		/*** Game Logic and Flow ***/
 
 	// Performance related
-	const unsigned short int MAX_ENEMIES = 24;	// never exceed this many enemies spawned at once
-	const unsigned short int FPS_CAP = 180;		// set to 0 to uncap
+	const unsigned short int MAX_ENEMIES = 24;	// never exceed this many enemies spawned at once (waves.txt can override)
+	const bool HORDE_MODE = false;				// load horde_waves.txt (thousands of enemies) instead of waves.txt
+	const unsigned short int FPS_CAP = 180;		// set to 0 to uncap, caps the simulation and rendering separately
 	const float FPS_UPDATE_INTERVAL = 0.333f;
+	const bool VSYNC = true;					// rendering waits for the display, the simulation never does
+	const bool PRINT_PROFILE = false;			// print frame timings to the console every PROFILE_WINDOW seconds
+	const float PROFILE_WINDOW = 1.0f;
+	const float HITCH_FACTOR = 2.0f;			// a presented frame taking this many times the recent average is a hitch,
+	const float HITCH_MIN_TIME = 1.0f / 30.0f;	// as long as it also took at least this long
+	const float HITCH_AVERAGE_WEIGHT = 0.05f;	// how quickly the recent average follows the frame time
+	const int PREWARM_TARGET_SIZE = 64;			// side of the offscreen target drawn into to warm up the pipeline
+	const int PREWARM_BATCH_SPRITES = 8;		// sprites in the run the warm-up sends through the render queue's batching
 	const float MASTER_VOLUME = 0.2f;			// 1.0 = max, 0.0 = muted
+	const float AUDIO_FULL_VOLUME_RADIUS = 4.0f;	// positional sounds fade out past this distance from the camera
+	const float AUDIO_CULL_RADIUS = 14.0f;		// and aren't played at all past this one (about 2 screens)
 	const int PARTICLE_AMOUNT = 80;
+	const int ENEMY_UPDATE_CHUNK = 64;			// enemies per job when updating in parallel
+	const int BULLET_COLLISION_CHUNK = 128;		// bullets per job when checking collisions in parallel
+	const int ENTITY_MOTION_CHUNK = 512;		// entities per job when moving them in parallel
+
+	// Enemy level of detail, enemies further than the far distance from the player update every
+	// ENEMY_LOD_INTERVAL frames with coarser steering, and go back to full detail inside the near distance
+	const float ENEMY_LOD_NEAR_DIST = 12.0f;	// past the edge of the screen, even on ultrawide windows
+	const float ENEMY_LOD_FAR_DIST = 14.0f;
+	const int ENEMY_LOD_INTERVAL = 4;
+
+	// Collision broad-phase
+	const float COLLISION_CELL_SIZE = 2.0f;
+	const float COLLISION_GRID_SPAN = 40.0f;	// the grid covers this square around the player, further out shares the edge cells
+	const float COLLISION_QUERY_RADIUS = 1.2f;	// largest enemy radius plus the player's, bullets are smaller
+	const float CHASER_ARM_REACH = 1.5f;		// how far a chaser's arm chain can reach past its body
+
+	// View culling
+	const float PARTICLE_CULL_RADIUS = 0.6f;	// furthest a particle gets from its emitter, in world units
+
+	// Static layer, background sprites are drawn into an offscreen cache and composited in one draw
+	const bool STATIC_LAYER_CACHE = true;		// false draws them one by one every frame, to compare in the profile
+	const float STATIC_LAYER_MARGIN = 2.0f;		// world units cached past each edge of the view
+	const float STATIC_LAYER_REFRESH_INTERVAL = 1.0f / 20.0f;	// spin animations in the cache update at this rate
+
+	// Depth, opaque texels are drawn front to back first so what they cover is rejected before shading
+	const bool OPAQUE_DEPTH_PASS = true;		// false draws everything back to front with blending, to compare in the profile
+
+	// Textures, every one but the font gets a mip chain built at load
+	const bool TEXTURE_COMPRESSION = false;		// store them S3TC compressed if the driver can, 4-6x smaller but blocky on the pixel art
+
+	// Streaming vertex data, written by the CPU every frame (e.g. batched sprites)
+	const int STREAM_RING_FRAMES = 3;			// frames the GPU can be behind before writing new data waits for it
+	const int STREAM_RING_FRAME_SIZE = 1 << 20;	// bytes each frame can stream, about 9000 sprites
+	const unsigned long long STREAM_RING_WAIT_NS = 1000000;	// how long to wait on a fence before checking again
+	const int SPRITE_BATCH_MAX = 2048;			// most sprites drawn in one batched call
+
+	// Timer wheel, 4 levels of 64 slots at 1/240s per tick covers about 19 hours
+	const float TIMER_WHEEL_TICK = 1.0f / 240.0f;
+	const int TIMER_WHEEL_SLOT_BITS = 6;
+	const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+	const int TIMER_WHEEL_LEVELS = 4;
 
 	// Math constants
 	const float PI = glm::pi<float>();
 	const float HALF_PI = glm::half_pi<float>();
 	const float TWO_PI = PI * 2.0f;
 
+	// Game World Layout, a grid of sectors each laid out like the original 40x40 arena
+	const float WORLD_CHUNK_SIZE = 8.0f;		// side of a streamed chunk
+	const int WORLD_SECTOR_CHUNKS = 5;			// chunks along one side of a sector
+	const int WORLD_SECTORS = 1;				// sectors along one side of the world, 10 makes a map 100x the area
+	const int WORLD_STREAM_RADIUS = 2;			// chunks kept loaded around the camera's chunk, in each direction
+	const float WORLD_SIZE = WORLD_CHUNK_SIZE * WORLD_SECTOR_CHUNKS * WORLD_SECTORS;
+
 	// Camera and Game World Constants
 	const float CAMERA_ZOOM = 0.25f;
 	const float CAMERA_SMOOTHNESS = 0.05f;
-	const float WORLD_SIZE = 40.0f;
 	const float CAMERA_X_BOUND = 16.0f;
 	const float CAMERA_Y_BOUND = 16.0f;
-	const float PLAYER_X_BOUND = 19.5f;
-	const float PLAYER_Y_BOUND = 19.5f;
+	const float PLAYER_X_BOUND = WORLD_SIZE * 0.5f - 0.5f;
+	const float PLAYER_Y_BOUND = WORLD_SIZE * 0.5f - 0.5f;
 
 	// Universal timers
 	const float INTRO_DURATION = 6.0f;
 	const float DEFAULT_ERASE_TIMER = 2.5f;
-	const float ENEMY_SPAWN_DELAY = 1.5f;
+	const float ENEMY_SPAWN_DELAY = 1.5f;		// defaults, waves.txt can override these two
+	const float WAVE_START_DELAY = 2.0f;
+	const float WAVE_RELOAD_INTERVAL = 1.0f;	// how often waves.txt is checked for changes
 	
 
 
@@ -158,6 +218,7 @@ namespace game {
 	// char limits
 	const unsigned int SMALL_HUD_LEN = 19;
 	const unsigned int LONG_HUD_LEN = 40;
+	const int MAX_TEXT_LENGTH = 40;			// most characters a text object can draw
 
 }
 
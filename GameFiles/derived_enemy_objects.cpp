@@ -9,16 +9,24 @@ namespace game {
 	/* GunnerEnemy Definitions */
 	/***************************/
 
-	/*** Constructor, initializes Gunner-specific defaults ***/
+	/*** Constructor, initializes Gunner-specific defaults. The orbit origin is read back from the store,
+	 * position may point into it and adding this object can move it ***/
 	GunnerEnemy::GunnerEnemy(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture)
-		: EnemyGameObject(position, geom, shader, texture), origin_pos(position) {
-		scale_ = glm::vec2(1.1f);
+		: EnemyGameObject(position, geom, shader, texture, ENEMY_GUNNER), origin_pos(GetPosition()) {
+		Scale() = glm::vec2(1.1f);
 		orbit_angle = 0;
-		health = GUNNER_INIT_HP;
+		Health() = GUNNER_INIT_HP;
 		damage = GUNNER_INIT_DMG;
 		point_reward = GUNNER_POINT_REWARD;
 		bullet_damage = GUNNER_INIT_BULLET_DMG;
-		time_since_last_shot = 0.0f;
+		shoot_timer = 0;
+		StartShootCooldown();
+	}
+
+
+	/*** Destructor, the cooldown can't fire once the gunner is gone ***/
+	GunnerEnemy::~GunnerEnemy() {
+		enemy_timers_->Cancel(shoot_timer);
 	}
 
 
@@ -27,50 +35,55 @@ namespace game {
 		EnemyGameObject::Update(delta_time);
 
 		// initalizations, provides small runtime optimizations
-		float distance_to_player = glm::distance(target_pos, position_);
+		float distance_to_player = glm::distance(target_pos, Position());
 		float dt = static_cast<float>(delta_time);
 
 		// move the orbit origin TOWARDS the player if the gunner is far away
 		if (distance_to_player > GUNNER_STAY_DIST) {
-			origin_pos += velocity_ * GUNNER_SPEED * speed_scale_factor * dt;
+			origin_pos += Velocity() * GUNNER_SPEED * speed_scale_factor * dt;
 		}
 
 		// move the orbit origin AWAY FROM the player if the player approaches
 		else if (distance_to_player < GUNNER_EVADE_DIST) {
-			origin_pos -= velocity_ * GUNNER_SPEED * speed_scale_factor * dt * 1.5f;
+			origin_pos -= Velocity() * GUNNER_SPEED * speed_scale_factor * dt * 1.5f;
 		}
 		
 		// rotate around a the origin position (via parametric equations)
 		orbit_angle += delta_time * ORBIT_SPEED;
-		position_.x = origin_pos.x + ORBIT_RADIUS * cos(orbit_angle);
-		position_.y = origin_pos.y + ORBIT_RADIUS * sin(orbit_angle);
+		glm::vec3& position = Position();
+		position.x = origin_pos.x + ORBIT_RADIUS * cos(orbit_angle);
+		position.y = origin_pos.y + ORBIT_RADIUS * sin(orbit_angle);
+	}
+
 
-		// update time_since_last_shot
-		time_since_last_shot += dt;
+	/*** Start the shooting cooldown, it runs on enemy time so cold shock slows it down with everything else ***/
+	void GunnerEnemy::StartShootCooldown(void) {
+		shoot_ready = false;
+		enemy_timers_->Cancel(shoot_timer);
+		shoot_timer = enemy_timers_->Schedule(GUNNER_SHOOT_CD, this, TIMER_GUNNER_SHOOT);
 	}
 
 
-	/*** Check if the gunner should shoot, non-timer method to help with cold shock implementation ***/
-	bool GunnerEnemy::IsShootCDFinished() {
-		if (time_since_last_shot > GUNNER_SHOOT_CD) {
-			time_since_last_shot = 0.0f;
-			return true;
+	/*** Shooting cooldown finished, the gunner shoots next time the player is in range ***/
+	void GunnerEnemy::OnTimer(int timer_id) {
+		if (timer_id == TIMER_GUNNER_SHOOT) {
+			shoot_timer = 0;
+			shoot_ready = true;
 		}
 		else {
-			return false;
+			EnemyGameObject::OnTimer(timer_id);
 		}
 	}
 
 
-
 	/***************************/
 	/* ArmObject Definitions   */
 	/***************************/
 
 	/*** Constructor, default values, ititalize off-screen ***/
 	ArmObject::ArmObject(const glm::vec3& offset, Geometry* geom, Shader* shader, const GLuint& texture)
-		: EnemyGameObject(glm::vec3(100.0f, 100.0f, 1.0f), geom, shader, texture), offset_from_parent(offset) {
-		scale_ = glm::vec2(0.3f);
+		: EnemyGameObject(glm::vec3(100.0f, 100.0f, 1.0f), geom, shader, texture, ENEMY_ARM), offset_from_parent(offset) {
+		Scale() = glm::vec2(0.3f);
 		local_angle = 0.0f;
 		sawblade_rotation_speed_ = 0.0f;
 		sawblade_rotation_ = 0.0f;
@@ -92,7 +105,7 @@ namespace game {
 		rotated_offset.y = offset_from_parent.x * s + offset_from_parent.y * c;
 
 		// apply offsets
-		position_ = parent_pos + rotated_offset;
+		Position() = parent_pos + rotated_offset;
 		SetRotation(local_angle - HALF_PI);
 	}
 
@@ -114,23 +127,20 @@ namespace game {
 		}
 	}
 
-	/*** Override render to allow rotation ***/
-	void ArmObject::Render(const glm::mat4& view_matrix, double current_time) {
+	/*** Override snapshot to allow rotation ***/
+	void ArmObject::AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const {
 		if (is_sawblade) {
-			// Save current rotation
-			float original_rotation = GetRotation();
-
-			// Add sawblade rotation
-			SetRotation(sawblade_rotation_);
-
-			// Render with combined rotation
-			GameObject::Render(view_matrix, current_time);
-
-			// Restore original rotation
-			SetRotation(original_rotation);
+			// Use the sawblade rotation in place of the arm's own
+			const glm::vec2& scale = GetScale();
+			glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale.x, scale.y, 1.0));
+			glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), sawblade_rotation_, glm::vec3(0.0, 0.0, 1.0));
+			glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), GetPosition());
+			glm::mat4 transform = translation_matrix * rotation_matrix * scaling_matrix;
+
+			snapshot.sprites[layer].push_back({ GetShader(), GetGeometry(), GetTexture(), transform, IsGhost() });
 		}
 		else {
-			GameObject::Render(view_matrix, current_time);
+			GameObject::AddToSnapshot(snapshot, layer);
 		}
 	}
 
@@ -142,9 +152,9 @@ namespace game {
 
 	/*** Constructor, initializes Chaser-specific defaults ***/
 	ChaserEnemy::ChaserEnemy(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture, const GLuint& base_texture, const GLuint& link_texture, const GLuint& saw_texture)
-		: EnemyGameObject(position, geom, shader, texture) {
-		scale_ = glm::vec2(0.9f);
-		health = CHASER_INIT_HP;
+		: EnemyGameObject(position, geom, shader, texture, ENEMY_CHASER) {
+		Scale() = glm::vec2(0.9f);
+		Health() = CHASER_INIT_HP;
 		damage = CHASER_INIT_DMG;
 		point_reward = CHASER_POINT_REWARD;
 		child_count = 3;
@@ -168,14 +178,21 @@ namespace game {
 	/*** Update, moves the chaser using the pursuit method, updates children based on parent ***/
 	void ChaserEnemy::Update(double delta_time) {
 		EnemyGameObject::Update(delta_time);
-		position_.x += velocity_.x * CHASER_SPEED * speed_scale_factor * delta_time;
-		position_.y += velocity_.y * CHASER_SPEED * speed_scale_factor * delta_time;
+		glm::vec3& position = Position();
+		const glm::vec3& velocity = Velocity();
+		position.x += velocity.x * CHASER_SPEED * speed_scale_factor * delta_time;
+		position.y += velocity.y * CHASER_SPEED * speed_scale_factor * delta_time;
+
+		// the arm chain stays frozen at reduced detail, it snaps back into place once the chaser is close again
+		if (!full_detail) {
+			return;
+		}
 
 		// calculate direction facing
-		float angle = atan2(velocity_.y, velocity_.x);
+		float angle = atan2(velocity.y, velocity.x);
 
 		// child1 transforms based on body
-		child1->UpdateFromParent(position_, angle, 0.03);
+		child1->UpdateFromParent(position, angle, 0.03);
 
 		// child2 transforms based on child1
 		child2->UpdateFromParent(child1->GetPosition(), child1->GetLocalAngle(), 0.01);
@@ -190,16 +207,16 @@ namespace game {
 	}
 
 
-	/*** Override render function to render parent and children ***/
-	void ChaserEnemy::Render(const glm::mat4& view_matrix, double current_time) {
+	/*** Override snapshot function to add parent and children ***/
+	void ChaserEnemy::AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const {
 		
-		child2->Render(view_matrix, current_time);
+		child2->AddToSnapshot(snapshot, layer);
 
-		child3->Render(view_matrix, current_time);
+		child3->AddToSnapshot(snapshot, layer);
 
-		child1->Render(view_matrix, current_time);
+		child1->AddToSnapshot(snapshot, layer);
 		
-		EnemyGameObject::Render(view_matrix, current_time);
+		EnemyGameObject::AddToSnapshot(snapshot, layer);
 	}
 
 
@@ -210,9 +227,9 @@ namespace game {
 
 	/*** Constructor, initializes Kamikaze-specific defaults ***/
 	KamikazeEnemy::KamikazeEnemy(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture)
-		: EnemyGameObject(position, geom, shader, texture) {
-		scale_ = glm::vec2(0.6f);
-		health = KAMIKAZE_INIT_HP;
+		: EnemyGameObject(position, geom, shader, texture, ENEMY_KAMIKAZE) {
+		Scale() = glm::vec2(0.6f);
+		Health() = KAMIKAZE_INIT_HP;
 		damage = KAMIKAZE_INIT_DMG;
 		point_reward = KAMIKAZE_POINT_REWARD;
 		explosion_radius = 0.0f;
@@ -223,26 +240,28 @@ namespace game {
 	/*** Update, moves the kamikaze using the pursuit method ***/
 	void KamikazeEnemy::Update(double delta_time) {
 		EnemyGameObject::Update(delta_time);
-		position_.x += velocity_.x * KAMIKAZE_SPEED * speed_scale_factor * delta_time;
-		position_.y += velocity_.y * KAMIKAZE_SPEED * speed_scale_factor * delta_time;
+		glm::vec3& position = Position();
+		const glm::vec3& velocity = Velocity();
+		position.x += velocity.x * KAMIKAZE_SPEED * speed_scale_factor * delta_time;
+		position.y += velocity.y * KAMIKAZE_SPEED * speed_scale_factor * delta_time;
 	}
 
 
 	/*** Updates the target position predictively by using param velocity (given no lock-on) ***/
 	void KamikazeEnemy::UpdateTarget(GameObject* obj) {
 		target_pos = obj->GetPosition();
-		float dist_to_player = glm::distance(target_pos, position_);
+		float dist_to_player = glm::distance(target_pos, Position());
 
-		// if the kamikaze is far enough from the player, use predictive pursuit
-		if (dist_to_player > KAMIKAZE_LOCKON_DIST) {
+		// if the kamikaze is far enough from the player, use predictive pursuit (plain pursuit at reduced detail)
+		if (full_detail && dist_to_player > KAMIKAZE_LOCKON_DIST) {
 			glm::vec3 predicted_pos = target_pos + obj->GetVelocity() * 1.5f;
 
 			// check for overshoot before using the prediction (overshoots returns negative dot prods)
-			if (glm::dot(predicted_pos - position_, target_pos - position_) >= 0) {
+			if (glm::dot(predicted_pos - Position(), target_pos - Position()) >= 0) {
 				target_pos = predicted_pos;
 			}
 		}
 
-		velocity_ = glm::normalize(target_pos - position_);
+		Velocity() = glm::normalize(target_pos - Position());
 	}
 }
@@ -16,11 +16,16 @@ namespace game {
         // Constructor, has unique default initializations
         GunnerEnemy(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture);
 
+        // Drops the shooting cooldown from the enemy timer wheel
+        ~GunnerEnemy();
+
         // Gunner-specific movement
         void Update(double delta_time) override;
 
-        // Check if the shooting cooldown has finished
-        bool IsShootCDFinished();
+        // Shooting cooldown, ready once it fires on the enemy timer wheel. Restarting it must not run in parallel
+        inline bool IsShootReady(void) const { return shoot_ready; }
+        void StartShootCooldown(void);
+        void OnTimer(int timer_id) override;
 
         // Bullet damage helper
         inline int GetBulletDamage(void) const { return bullet_damage; }
@@ -32,7 +37,8 @@ namespace game {
 
         // shooting vars
         unsigned short int bullet_damage;
-        float time_since_last_shot;
+        bool shoot_ready;
+        TimerHandle shoot_timer;
     };
 
 
@@ -50,7 +56,7 @@ namespace game {
         inline void SetSawbladeRotationSpeed(float speed) { sawblade_rotation_speed_ = speed; }
         float GetSawbladeRotation() const { return sawblade_rotation_; }
         void SetIsSawblade(bool is_saw);
-        void ArmObject::Render(const glm::mat4& view_matrix, double current_time) override;
+        void AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const override;
 
     private:
         // dist from parent
@@ -75,7 +81,8 @@ namespace game {
         // Chaser-specific movement
         void Update(double delta_time) override;
 
-        void ChaserEnemy::Render(const glm::mat4& view_matrix, double current_time);
+        // Adds the arm chain, then the body on top
+        void AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const override;
 
         ArmObject* GetChild1() const { return child1; }
         ArmObject* GetChild2() const { return child2; }
@@ -6,42 +6,80 @@
 
 namespace game {
 
+	// Shared by all enemies, set by the Game on Init
+	TimerWheel* EnemyGameObject::enemy_timers_ = NULL;
+
+
 	/*** Constructor ***/
-	EnemyGameObject::EnemyGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture)
-		: GameObject(position, geom, shader, texture) {
+	EnemyGameObject::EnemyGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture, EnemyType type)
+		: GameObject(position, geom, shader, texture), type(type) {
 		// initialize to default values
-		health = 1;
+		Health() = 1;
 		damage = 0;
 		point_reward = 0;
 		exploded = false;
 		target_angle = 0.0f;
 		target_pos = glm::vec3(0.0f);
 		speed_scale_factor = 1;
+
+		// spread reduced updates over the interval, so far enemies don't all update on the same frame
+		full_detail = true;
+		detail_countdown = entity_ % ENEMY_LOD_INTERVAL;
+		skipped_time = 0.0;
 	}
 
 
-	/*** Base Update function, ensures enemy faces the player, smooth rotation ***/
+	/*** Base Update function, ensures enemy faces the player, smooth rotation (snaps at reduced detail) ***/
 	void EnemyGameObject::Update(double delta_time) {
-		glm::vec3 aim_line = target_pos - position_;
+		glm::vec3 aim_line = target_pos - Position();
 		target_angle = atan2(aim_line.y, aim_line.x) - (HALF_PI);
-		angle_ = LerpAngle(angle_, target_angle, 0.05f);
+		if (full_detail) {
+			Angle() = LerpAngle(Angle(), target_angle, 0.05f);
+		}
+		else {
+			Angle() = target_angle;
+		}
+	}
+
+
+	/*** Pick the level of detail from the distance to the player, then update if it's this enemy's turn ***/
+	bool EnemyGameObject::UpdateWithDetail(double delta_time, float dist_to_player) {
+
+		// the gap between the two distances stops enemies on the edge from switching every frame
+		if (full_detail && dist_to_player > ENEMY_LOD_FAR_DIST) {
+			full_detail = false;
+		}
+		else if (!full_detail && dist_to_player < ENEMY_LOD_NEAR_DIST) {
+			full_detail = true;
+		}
+
+		// reduced detail, save the time up until it's this enemy's turn
+		skipped_time += delta_time;
+		if (!full_detail && --detail_countdown > 0) {
+			return false;
+		}
+		detail_countdown = ENEMY_LOD_INTERVAL;
+
+		Update(skipped_time);
+		skipped_time = 0.0;
+		return true;
 	}
 
 
 	/*** Base UpdateTarget function, updates the target_pos and adjusts velocity accordingly ***/
 	void EnemyGameObject::UpdateTarget(GameObject* obj) {
 		target_pos = obj->GetPosition();
-		velocity_ = glm::normalize(target_pos - position_);
+		Velocity() = glm::normalize(target_pos - Position());
 	}
 
 
 	/*** Subtract param damage from health ***/
 	void EnemyGameObject::TakeDamage(int recieved_dmg) {
-		if (health > 0) {
-			health -= recieved_dmg;
+		if (Health() > 0) {
+			Health() -= recieved_dmg;
 		}
-		else if (health < 0) {
-			health = 0;
+		else if (Health() < 0) {
+			Health() = 0;
 		}
 	}
 
@@ -14,11 +14,19 @@
 
 namespace game {
 
+    // Every kind of enemy, lets per-frame code branch on the type instead of using dynamic_cast
+    enum EnemyType {
+        ENEMY_GUNNER = 1,
+        ENEMY_CHASER = 2,
+        ENEMY_KAMIKAZE = 3,
+        ENEMY_ARM = 4
+    };
+
     // Inherits from GameObject
     class EnemyGameObject : public GameObject {
 
     public:
-        EnemyGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture);
+        EnemyGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture, EnemyType type);
 
         // Base Enemy Update function, defined more in-depth in derived classes
         virtual void Update(double delta_time) override;
@@ -26,11 +34,18 @@ namespace game {
         // Retrieve the players updated position
         virtual void UpdateTarget(GameObject* obj);
 
+        /* Update at the enemy's level of detail. Far from the player it only updates every
+         * ENEMY_LOD_INTERVAL frames, catching up on the time it skipped, and Update/UpdateTarget
+         * use coarser steering. Returns false on frames it was skipped */
+        bool UpdateWithDetail(double delta_time, float dist_to_player);
+        inline bool IsFullDetail(void) const { return full_detail; }
+
         // Getters
-        inline int GetHealth(void) const { return health; }
+        inline int GetHealth(void) const { return GetStoredHealth(); }
         inline int GetDamage(void) const { return damage; }
         inline int GetPointReward(void) const { return point_reward; }
         inline bool IsExploded(void) const { return exploded; }
+        inline EnemyType GetType(void) const { return type; }
 
         // Setters
         inline void SetDamage(int dmg) { damage = dmg; }
@@ -40,19 +55,28 @@ namespace game {
         void TakeDamage(int recieved_dmg);
 
         // Scaling for health and speed
-        inline void SetHealthScale(float scale_factor) { health = floor(health * scale_factor); }
+        inline void SetHealthScale(float scale_factor) { Health() = floor(Health() * scale_factor); }
         inline void SetSpeedScale(float scale_factor) { speed_scale_factor = scale_factor; }
 
+        // Wheel for timers that run on enemy time, which cold shock slows down. Set once before any enemies are created
+        static void SetEnemyTimerWheel(TimerWheel* timers) { enemy_timers_ = timers; }
+
     protected:
         // member vars to be inherited by all enemy types
-        int health;
+        EnemyType type;
         int damage;
         unsigned short int point_reward;
         bool exploded;
         float target_angle;
         glm::vec3 target_pos;
         float speed_scale_factor;
-        
+
+        // level of detail, frames left until the next reduced update and the time skipped since the last one
+        bool full_detail;
+        int detail_countdown;
+        double skipped_time;
+
+        static TimerWheel* enemy_timers_;
 
     }; // class EnemyGameObject
 
@@ -0,0 +1,101 @@
+// EntityStore class definitions
+
+#include "entity_store.h"
+
+namespace game {
+
+    /*** Constructor, the store starts out empty ***/
+    EntityStore::EntityStore(void) {}
+
+
+    /*** Add an entity at the end of every component array ***/
+    Entity EntityStore::Create(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture) {
+
+        // reuse a destroyed entity's handle if there is one
+        Entity entity;
+        if (!free_.empty()) {
+            entity = free_.back();
+            free_.pop_back();
+        }
+        else {
+            entity = static_cast<Entity>(slot_.size());
+            slot_.push_back(-1);
+        }
+        slot_[entity] = GetCount();
+        entity_.push_back(entity);
+
+        // default components
+        this->position.push_back(position);
+        scale.push_back(glm::vec2(1.0f));
+        angle.push_back(0.0f);
+        velocity.push_back(glm::vec3(0.0f));
+        acceleration.push_back(glm::vec3(0.0f));
+        move_speed.push_back(0.0f);
+        expired.push_back(false);
+        health.push_back(0);
+        this->shader.push_back(shader);
+        geometry.push_back(geom);
+        this->texture.push_back(texture);
+        ghost.push_back(false);
+        hidden.push_back(false);
+
+        return entity;
+    }
+
+
+    /*** Remove an entity, the last entity is moved into its slot to keep the arrays packed ***/
+    void EntityStore::Destroy(Entity entity) {
+        int slot = slot_[entity];
+        int last = GetCount() - 1;
+
+        // move the last entity down
+        if (slot != last) {
+            position[slot] = position[last];
+            scale[slot] = scale[last];
+            angle[slot] = angle[last];
+            velocity[slot] = velocity[last];
+            acceleration[slot] = acceleration[last];
+            move_speed[slot] = move_speed[last];
+            expired[slot] = expired[last];
+            health[slot] = health[last];
+            shader[slot] = shader[last];
+            geometry[slot] = geometry[last];
+            texture[slot] = texture[last];
+            ghost[slot] = ghost[last];
+            hidden[slot] = hidden[last];
+
+            Entity moved = entity_[last];
+            entity_[slot] = moved;
+            slot_[moved] = slot;
+        }
+
+        // drop the last slot
+        position.pop_back();
+        scale.pop_back();
+        angle.pop_back();
+        velocity.pop_back();
+        acceleration.pop_back();
+        move_speed.pop_back();
+        expired.pop_back();
+        health.pop_back();
+        shader.pop_back();
+        geometry.pop_back();
+        texture.pop_back();
+        ghost.pop_back();
+        hidden.pop_back();
+        entity_.pop_back();
+
+        slot_[entity] = -1;
+        free_.push_back(entity);
+    }
+
+
+    /*** Move a range of entities along their velocity ***/
+    void EntityStore::IntegrateMotion(int begin, int end, double delta_time) {
+        float dt = static_cast<float>(delta_time);
+        for (int i = begin; i < end; ++i) {
+            position[i] += velocity[i] * (move_speed[i] * dt);
+        }
+    }
+
+} // namespace game
@@ -0,0 +1,81 @@
+// EntityStore class declarations, holds the components of every GameObject in flat arrays (one per
+// component) so systems can walk them without chasing pointers
+
+#ifndef ENTITY_STORE_H_
+#define ENTITY_STORE_H_
+
+#define GLEW_STATIC
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "geometry.h"
+
+namespace game {
+
+    // Handle to an entity, stays the same while other entities come and go
+    typedef unsigned int Entity;
+
+
+    /* Structure-of-arrays storage for entities. Each component is a vector
+     * indexed by slot, and every vector has one element per live entity.
+     * Destroying an entity moves the last one into its slot, so the arrays
+     * never have holes and an Entity handle has to be turned into a slot
+     * with GetSlot() each time. Creating and destroying entities must not
+     * overlap with anything else touching the store, reading and writing
+     * different slots from several threads at once is fine */
+    class EntityStore {
+
+        public:
+            EntityStore(void);
+
+            // Add an entity with default components, or remove one
+            Entity Create(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture);
+            void Destroy(Entity entity);
+
+            // Slot of a live entity in the component arrays
+            inline int GetSlot(Entity entity) const { return slot_[entity]; }
+
+            // Number of live entities, slots run from 0 to this
+            inline int GetCount(void) const { return static_cast<int>(position.size()); }
+
+            // Movement system, moves slots [begin, end) along their velocity scaled by move_speed
+            void IntegrateMotion(int begin, int end, double delta_time);
+
+            /* COMPONENTS, public so systems can walk them directly */
+
+            // Transform
+            std::vector<glm::vec3> position;
+            std::vector<glm::vec2> scale;
+            std::vector<float> angle;
+
+            // Motion, move_speed is 0 for entities that move themselves in Update
+            std::vector<glm::vec3> velocity;
+            std::vector<glm::vec3> acceleration;
+            std::vector<float> move_speed;
+
+            // Lifetime, set when the entity's erase timer fires
+            std::vector<unsigned char> expired;
+
+            // Health, for the entities that can take damage
+            std::vector<int> health;
+
+            // Render info
+            std::vector<Shader*> shader;
+            std::vector<Geometry*> geometry;
+            std::vector<GLuint> texture;
+            std::vector<unsigned char> ghost;
+            std::vector<unsigned char> hidden;
+
+        private:
+            // Slot of each entity (-1 once destroyed), the entity in each slot, and handles free for reuse
+            std::vector<int> slot_;
+            std::vector<Entity> entity_;
+            std::vector<Entity> free_;
+    };
+
+} // namespace game
+
+#endif // ENTITY_STORE_H_
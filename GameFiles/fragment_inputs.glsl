@@ -0,0 +1,8 @@
+// Shared by the fragment shaders, included after the #version line
+
+// Attributes passed from the vertex shader
+in vec4 color_interp;
+in vec2 uv_interp;
+
+// Texture sampler
+uniform sampler2D onetex;
@@ -0,0 +1,32 @@
+// FrameUniforms class definitions
+
+#include "frame_uniforms.h"
+
+namespace game {
+
+    /*** Constructor, the buffer is made in Init ***/
+    FrameUniforms::FrameUniforms(void) : buffer_(0) {}
+
+
+    /*** Destructor, frees the buffer ***/
+    FrameUniforms::~FrameUniforms() {
+        glDeleteBuffers(1, &buffer_);
+    }
+
+
+    /*** Create the buffer and leave it bound to its binding point for good ***/
+    void FrameUniforms::Init(void) {
+        glGenBuffers(1, &buffer_);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_STREAM_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, buffer_);
+    }
+
+
+    /*** Upload this frame's data, re-specifying the store lets the driver keep the last frame's while it's in use ***/
+    void FrameUniforms::Update(const FrameData& data) {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), &data, GL_STREAM_DRAW);
+    }
+
+} // namespace game
@@ -0,0 +1,10 @@
+// Per-frame data shared by every program, written once a frame by Game::Render (FrameData in frame_uniforms.h)
+// Include it right after the #version line, #extension isn't allowed once the shader has any declarations
+#extension GL_ARB_uniform_buffer_object : require
+
+layout(std140) uniform FrameData {
+    mat4 view_matrix;
+    vec4 camera_pos;
+    vec2 viewport_size;
+    float time;
+};
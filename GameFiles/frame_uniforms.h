@@ -0,0 +1,47 @@
+// FrameUniforms class declarations, the uniform buffer holding what every shader needs once per frame
+
+#ifndef FRAME_UNIFORMS_H_
+#define FRAME_UNIFORMS_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Binding point of the FrameData block, every program's block is bound to it
+    const GLuint FRAME_UNIFORM_BINDING = 0;
+
+    /* Contents of the FrameData uniform block in frame_uniforms.glsl, laid out by std140 rules:
+     * the vec3 camera position takes a whole vec4, and the struct is padded to a multiple of 16 bytes */
+    struct FrameData {
+        glm::mat4 view_matrix;
+        glm::vec4 camera_pos;
+        glm::vec2 viewport_size;    // in pixels
+        float time;                 // seconds, drives the particle animation
+        float padding;
+    };
+
+
+    /* Owns the buffer behind the FrameData block. It stays bound to
+     * FRAME_UNIFORM_BINDING, so writing it once a frame updates every program */
+    class FrameUniforms {
+
+        public:
+            FrameUniforms(void);
+            ~FrameUniforms();
+
+            // Create the buffer and bind it, needs a current GL context
+            void Init(void);
+
+            // Replace the contents for this frame
+            void Update(const FrameData& data);
+
+        private:
+            GLuint buffer_;
+
+    }; // class FrameUniforms
+
+} // namespace game
+
+#endif // FRAME_UNIFORMS_H_
@@ -14,10 +14,13 @@ const unsigned int window_width_g = 900;
 const unsigned int window_height_g = 600;
 const glm::vec3 viewport_background_color_g(0.1, 0.1, 0.1);
 
+// Linked shader programs from earlier runs, relative to the working directory
+const std::string shader_cache_file_g = "shader_cache.bin";
+
 namespace game {
 
     /*** Constructor is unused, replaced by Init() ***/
-    Game::Game(void) {}
+    Game::Game(void) : enemy_grid(COLLISION_GRID_SPAN, COLLISION_CELL_SIZE) {}
 
 
     /*** Destructor ***/
@@ -28,7 +31,6 @@ namespace game {
 
         // Free rendering resources
         delete sprite_;
-        delete tiling_sprite_;
         delete particles_;
         delete player_particles_;
 
@@ -62,6 +64,9 @@ namespace game {
         // Make the window's OpenGL context the current one
         glfwMakeContextCurrent(window_);
 
+        // Wait for the display when presenting, only the main thread is held up by it
+        glfwSwapInterval(VSYNC ? 1 : 0);
+
         // Store the Game instance in GLFWwindow's user data for callbacks
         glfwSetWindowUserPointer(window_, this);
 
@@ -101,14 +106,15 @@ namespace game {
             std::cerr << "Failed to load window icon: " << icon_path << std::endl;
         }
 
+        // Every GameObject created from here on keeps its components in the entity store, and its timers on the wheels
+        GameObject::SetEntityStore(&entities);
+        GameObject::SetTimerWheel(&timers);
+        EnemyGameObject::SetEnemyTimerWheel(&enemy_timers);
+
         // Initialize sprite geometry
         sprite_ = new Sprite();
         sprite_->CreateGeometry();
 
-        // Initialize tiling sprite geometry
-        tiling_sprite_ = new Sprite();
-        tiling_sprite_->CreateTilingGeometry();
-
         // Initialize particle geometry
         Particles* particles_temp = new Particles();
         particles_temp->CreateGeometry(PARTICLE_AMOUNT);
@@ -119,35 +125,96 @@ namespace game {
         particles_temp_2->CreatePlayerGeometry(PARTICLE_AMOUNT * 5.0f);
         player_particles_ = particles_temp_2;
 
-        // Initialize sprite shader
-        sprite_shader_.Init((resources_directory_g + std::string("/sprite_vertex_shader.glsl")).c_str(),
-            (resources_directory_g + std::string("/sprite_fragment_shader.glsl")).c_str());
-        
-        // Initialize text shader
-        text_shader_.Init((resources_directory_g + std::string("/sprite_vertex_shader.glsl")).c_str(),
-            (resources_directory_g + std::string("/text_fragment_shader.glsl")).c_str());
-
-        // Initialize particle shader
-        particle_shader_.Init((resources_directory_g + std::string("/particle_vertex_shader.glsl")).c_str(),
-            (resources_directory_g + std::string("/particle_fragment_shader.glsl")).c_str());
+        // Initialize the shaders, cached binaries are used when they match, everything else is
+        // submitted before waiting on any of it so the driver can compile them in parallel
+        double shader_start = glfwGetTime();
+        ShaderCache shader_cache(shader_cache_file_g);
+        Shader::EnableParallelCompile();
 
-        // Initialize player particle shader
-        player_particle_shader_.Init((resources_directory_g + std::string("/particle_vertex_shader_2.glsl")).c_str(),
-            (resources_directory_g + std::string("/particle_fragment_shader_2.glsl")).c_str());
-
-        // Initialize time
-        current_time_ = 0.0;
+        // sprite shader, with ghost and opaque variants
+        sprite_shader_.Begin((resources_directory_g + std::string("/sprite_vertex_shader.glsl")).c_str(),
+            (resources_directory_g + std::string("/sprite_fragment_shader.glsl")).c_str(), shader_cache,
+            std::vector<std::string>(), { "GHOST", "OPAQUE" });
+        
+        // text shader, with a variant that draws glyphs and one that shows the font texture as is
+        text_shader_.Begin((resources_directory_g + std::string("/sprite_vertex_shader.glsl")).c_str(),
+            (resources_directory_g + std::string("/text_fragment_shader.glsl")).c_str(), shader_cache,
+            std::vector<std::string>(), { "GLYPHS" });
+
+        // particle shader
+        particle_shader_.Begin((resources_directory_g + std::string("/particle_vertex_shader.glsl")).c_str(),
+            (resources_directory_g + std::string("/particle_fragment_shader.glsl")).c_str(), shader_cache, { "TRAIL" });
+
+        // player particle shader, the same source built as the aura
+        player_particle_shader_.Begin((resources_directory_g + std::string("/particle_vertex_shader.glsl")).c_str(),
+            (resources_directory_g + std::string("/particle_fragment_shader.glsl")).c_str(), shader_cache, { "AURA" });
+
+        // screen shader, the starfield and a vignette variant
+        screen_shader_.Begin((resources_directory_g + std::string("/screen_vertex_shader.glsl")).c_str(),
+            (resources_directory_g + std::string("/screen_fragment_shader.glsl")).c_str(), shader_cache,
+            std::vector<std::string>(), { "VIGNETTE" });
+
+        sprite_shader_.Finish(shader_cache);
+        text_shader_.Finish(shader_cache);
+        particle_shader_.Finish(shader_cache);
+        player_particle_shader_.Finish(shader_cache);
+        screen_shader_.Finish(shader_cache);
+        shader_cache.Save();
+
+        // per-frame uniforms, every program reads its view and time from the one buffer
+        frame_uniforms_.Init();
+        sprite_shader_.SetUniformBlockBinding("FrameData", FRAME_UNIFORM_BINDING);
+        text_shader_.SetUniformBlockBinding("FrameData", FRAME_UNIFORM_BINDING);
+        particle_shader_.SetUniformBlockBinding("FrameData", FRAME_UNIFORM_BINDING);
+        player_particle_shader_.SetUniformBlockBinding("FrameData", FRAME_UNIFORM_BINDING);
+        screen_shader_.SetUniformBlockBinding("FrameData", FRAME_UNIFORM_BINDING);
+
+        // sprites on the shared quad are batched through a ring of per-frame vertex space
+        sprite_stream_.Init(GL_ARRAY_BUFFER, STREAM_RING_FRAME_SIZE);
+        render_queue_.InitBatching(sprite_, &sprite_stream_);
+
+        // report startup cost, a warm start is one where every program came from the cache
+        if (PRINT_PROFILE) {
+            std::cout << "Shaders ready in " << (glfwGetTime() - shader_start) * 1000.0 << "ms ("
+                << (shader_cache.GetMisses() == 0 && shader_cache.GetHits() > 0 ? "warm" : "cold") << " start, "
+                << shader_cache.GetHits() << " cached, " << shader_cache.GetMisses() << " compiled)" << std::endl;
+        }
+
+        // Load the wave definitions, edits to the file are picked up while the game runs
+        std::string wave_file = HORDE_MODE ? "/horde_waves.txt" : "/waves.txt";
+        waves.LoadFromFile((resources_directory_g + wave_file).c_str());
+        enemy_arr.reserve(waves.GetMaxEnemies());
+        rng.seed(rd());
+        next_spawn_portal = 0;
+
+        // Start the worker threads, each gets its own buffer for enemy side effects
+        jobs.Init();
+        enemy_events.resize(jobs.GetThreadCount());
+        contacts.resize(jobs.GetThreadCount());
 
         // Start all the Timers
-        enemy_spawn_timer.Start(ENEMY_SPAWN_DELAY);
+        enemy_spawn_timer.Start(waves.GetSpawnDelay());
         firing_cooldown.Start(PISTOL_SHOOT_CD);
         update_fps_timer.Start(FPS_UPDATE_INTERVAL);
+        wave_reload_timer.Start(WAVE_RELOAD_INTERVAL);
+        profile_timer.Start(PROFILE_WINDOW);
+
+        // Nothing pressed until the first poll
+        latest_input = InputState();
+        latest_input.window_width = window_width_;
+        latest_input.window_height = window_height_;
+        latest_input.poll_time = glfwGetTime();
+        input = latest_input;
 
         // Initialize default member variables
+        simulation_running = false;
+        playing_intro = false;
+        intro_start_time = 0.0;
         update_flag = false;
         holding_shoot = false;
         holding_interact = false;
         game_won = false;
+        pipeline_warm = false;
         camera_pos = glm::vec3(0.0f);
         camera_target_pos = glm::vec3(0.0f);
         cursor_pos = glm::vec3(0.0f);
@@ -163,90 +230,79 @@ namespace game {
     /*** Initialize audio files and data ***/
     void Game::InitAudio(void) {
         try {
-            // Initialize audio manager and position of listener
+            /* AddSound takes (file, polyphony, priority, positional): polyphony is how many copies may overlap,
+             * priority 0 = enemy noise, 1 = explosions, 2 = player feedback, 3 = game events,
+             * positional sounds are played where they happen with PlaySoundAt, the rest sit on the listener */
+
+            // Initialize audio manager, the listener follows the camera from here on
             am.Init(NULL);
             am.SetListenerPosition(0.0, 0.0, 0.0);
+            am.SetAttenuation(AUDIO_FULL_VOLUME_RADIUS, AUDIO_CULL_RADIUS);
 
-            // Setup the background music (bg_music)
+            // Setup the background music (bg_music), streamed since it's the longest track
             std::string filename = std::string(resources_directory_g).append("/audio/bg_music.wav");
-            bg_music = am.AddSound(filename.c_str());
-            am.SetSoundPosition(bg_music, 0.0, 0.0, 0.0); // sound properties
+            bg_music = am.AddStream(filename.c_str());
             am.SetLoop(bg_music, true);
 
             // Setup the game starting sound
             filename = std::string(resources_directory_g).append("/audio/game_start.wav");
-            game_start_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(game_start_sfx, 0.0, 0.0, 0.0);
+            game_start_sfx = am.AddSound(filename.c_str(), 1, 3);
 
             // Setup the explosion sound
             filename = std::string(resources_directory_g).append("/audio/explosion.wav");
-            boom_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(boom_sfx, 0.0, 0.0, 0.0);
+            boom_sfx = am.AddSound(filename.c_str(), 6, 1, true);
 
             // Setup the game over sound
             filename = std::string(resources_directory_g).append("/audio/game_over.wav");
-            game_over_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(game_over_sfx, 0.0, 0.0, 0.0);
+            game_over_sfx = am.AddSound(filename.c_str(), 1, 3);
 
             // Setup the collect sound
             filename = std::string(resources_directory_g).append("/audio/collect_power_up.wav");
-            collect_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(collect_sfx, 0.0, 0.0, 0.0);
+            collect_sfx = am.AddSound(filename.c_str(), 1, 2);
 
             // Setup the ambience played by power ups
             filename = std::string(resources_directory_g).append("/audio/power_up_loop.wav");
-            power_up_ambience = am.AddSound(filename.c_str());
-            am.SetSoundPosition(power_up_ambience, 0.0, 0.0, 0.0);
+            power_up_ambience = am.AddStream(filename.c_str());
 
             // Setup the player hit sound
             filename = std::string(resources_directory_g).append("/audio/player_hit.wav");
-            player_hit_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(player_hit_sfx, 0.0, 0.0, 0.0);
+            player_hit_sfx = am.AddSound(filename.c_str(), 2, 2);
 
             // Setup the player shoot sound
             filename = std::string(resources_directory_g).append("/audio/player_shoot.wav");
-            player_shoot_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(player_shoot_sfx, 0.0, 0.0, 0.0);
+            player_shoot_sfx = am.AddSound(filename.c_str(), 3, 2);
 
             // Setup the enemy hit sound
             filename = std::string(resources_directory_g).append("/audio/enemy_hit.wav");
-            enemy_hit_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(enemy_hit_sfx, 0.0, 0.0, 0.0);
+            enemy_hit_sfx = am.AddSound(filename.c_str(), 6, 0, true);
 
             // Setup the enemy shoot sound
             filename = std::string(resources_directory_g).append("/audio/enemy_shoot.wav");
-            enemy_shoot_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(enemy_shoot_sfx, 0.0, 0.0, 0.0);
+            enemy_shoot_sfx = am.AddSound(filename.c_str(), 4, 0, true);
 
             // Setup the wave complete sound
             filename = std::string(resources_directory_g).append("/audio/wave_complete.wav");
-            wave_complete_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(wave_complete_sfx, 0.0, 0.0, 0.0);
+            wave_complete_sfx = am.AddSound(filename.c_str(), 1, 3);
 
             // Setup the smg shot sound
             filename = std::string(resources_directory_g).append("/audio/smg_shoot.wav");
-            smg_shoot_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(smg_shoot_sfx, 0.0, 0.0, 0.0);
+            smg_shoot_sfx = am.AddSound(filename.c_str(), 4, 2);
 
             // Setup the rifle shot sound
             filename = std::string(resources_directory_g).append("/audio/rifle_shoot.wav");
-            rifle_shoot_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(rifle_shoot_sfx, 0.0, 0.0, 0.0);
+            rifle_shoot_sfx = am.AddSound(filename.c_str(), 4, 2);
 
             // Setup the sniper shot sound
             filename = std::string(resources_directory_g).append("/audio/sniper_shoot.wav");
-            sniper_shoot_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(sniper_shoot_sfx, 0.0, 0.0, 0.0);
+            sniper_shoot_sfx = am.AddSound(filename.c_str(), 2, 2);
 
             // Setup the purchase sound
             filename = std::string(resources_directory_g).append("/audio/purchase.wav");
-            purchase_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(purchase_sfx, 0.0, 0.0, 0.0);
+            purchase_sfx = am.AddSound(filename.c_str(), 1, 3);
 
             // Setup the purchase sound
             filename = std::string(resources_directory_g).append("/audio/win_game.wav");
-            win_game_sfx = am.AddSound(filename.c_str());
-            am.SetSoundPosition(win_game_sfx, 0.0, 0.0, 0.0);
+            win_game_sfx = am.AddSound(filename.c_str(), 1, 3);
 
             // Set the master volume to a low value to avoid jumpscaring the listener
             am.SetMasterGain(MASTER_VOLUME);
@@ -304,7 +360,7 @@ namespace game {
         textures.push_back("/textures/gunner_ship.png");        // 1,  tex_gunner
         textures.push_back("/textures/chaser_ship.png");        // 2,  tex_chaser
         textures.push_back("/textures/kamikaze_ship.png");      // 3,  tex_kamikaze
-        textures.push_back("/textures/background.png");         // 4,  tex_stars
+        textures.push_back("");                                 // 4,  tex_stars, drawn by the screen shader now
         textures.push_back("/textures/explosion.png");          // 5,  tex_explosion
         textures.push_back("/textures/bullet.png");             // 6,  tex_bullet
         textures.push_back("/textures/enemy_spawn.png");        // 7,  tex_portal
@@ -312,7 +368,7 @@ namespace game {
         textures.push_back("/textures/bullet_boost.png");       // 9,  tex_bullet_boost
         textures.push_back("/textures/cold_shock.png");         // 10, tex_cold_shock
         textures.push_back("/textures/font.png");               // 11, tex_font
-        textures.push_back("/textures/vignette.png");           // 12, tex_vignette
+        textures.push_back("");                                 // 12, tex_vignette, drawn by the screen shader now
         textures.push_back("/textures/dp_icon.png");            // 13, tex_dp_icon
         textures.push_back("/textures/bb_icon.png");            // 14, tex_bb_icon
         textures.push_back("/textures/cs_icon.png");            // 15, tex_cs_icon
@@ -334,7 +390,7 @@ namespace game {
         textures.push_back("/textures/nitro_infuse.png");       // 31, tex_nitro_infuse
         textures.push_back("/textures/celestial_augment.png");  // 32, tex_celestial_augment
         textures.push_back("/textures/win_screen.png");         // 33, tex_win_screen
-        LoadTextures(textures);
+        LoadTextures(textures, { tex_font });
 
         // Setup the player object and its particle aura
         player = new PlayerGameObject(glm::vec3(0.0f, 0.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_player]);
@@ -343,15 +399,9 @@ namespace game {
         );
         particle_system_arr.push_back(player_particles);
 
-        // Setup 8 enemy spawn points on the outside of the map (represented by portal sprites)
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(16.0f, -9.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(16.0f, 9.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(9.0f, 16.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(-9.0f, 16.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(-16.0f, 9.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(-16.0f, -9.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(-9.0f, -16.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
-        enemy_spawn_arr.push_back(new EnemySpawn(glm::vec3(9.0f, -16.0f, 0.0f), sprite_, &sprite_shader_, tex_[tex_portal]));
+        // Setup the world, enemy spawn points (portal sprites) are streamed in by chunk
+        world = new WorldChunks(sprite_, &sprite_shader_, tex_[tex_portal]);
+        world->Stream(player->GetPosition());
 
         // Setup the HUD
         hud = new HUD(sprite_, &text_shader_, &sprite_shader_, tex_[tex_font], tex_[tex_dp_icon], tex_[tex_bb_icon], tex_[tex_cs_icon]);
@@ -360,18 +410,11 @@ namespace game {
         title = new TextGameObject(title_offset, sprite_, &text_shader_, tex_[tex_font]);
         title->SetText("Celestial Onslaught");
 
-        // Setup the vignette (lighting effect)
-        vignette = new GameObject(glm::vec3(0.0f), sprite_, &sprite_shader_, tex_[tex_vignette]);
-        vignette->SetScale(glm::vec2(45.0f));
 
         // Initialize win image
         win_image = new GameObject(glm::vec3(0, 0, 0), sprite_, &sprite_shader_, tex_[tex_win_screen]);
         win_image->Hide();
 
-        // Setup background
-        background = new GameObject(glm::vec3(0.0f), tiling_sprite_, &sprite_shader_, tex_[tex_stars]);
-        background->SetScale(glm::vec2(WORLD_SIZE));
-
 
         /* Setup Buyable Areas */
 
@@ -461,8 +504,7 @@ namespace game {
 
         // delete single pointer game objects
         delete player;
-        delete background;
-        delete vignette;
+        delete world;
         delete hud;
         delete title;
 
@@ -486,11 +528,6 @@ namespace game {
             delete collectible_arr[i];
         }
 
-        // delete enemy spawns
-        for (int i = 0; i < enemy_spawn_arr.size(); ++i) {
-            delete enemy_spawn_arr[i];
-        }
-
         // delete buyables
         for (int i = 0; i < buyable_arr.size(); ++i) {
             delete buyable_arr[i];
@@ -512,111 +549,241 @@ namespace game {
     }
 
 
-    /*** Play the Intro sequence, might be better to put this in MainLoop() idk ***/
+    /*** Start the Intro sequence, it plays out on the simulation thread once MainLoop() starts ***/
     void Game::PlayIntro(void) {
-
-        // initialize the intro
         intro_timer.Start(INTRO_DURATION);
+        intro_start_time = glfwGetTime();
+        playing_intro = true;
         am.PlaySound(game_start_sfx);
-        double last_time = glfwGetTime();
-        double intro_start_time = glfwGetTime();
+    }
 
-        // hang until the intro timer is done
-        while (!intro_timer.Finished()) {
 
-            // exit if specified by the user
-            if (glfwWindowShouldClose(window_)) { break; }
+    /*** Show the intro countdown, then start the game once it's done ***/
+    void Game::UpdateIntro(void) {
+        double time_in_intro = glfwGetTime() - intro_start_time;
 
-            // track time
-            double current_time = glfwGetTime();
-            double time_in_intro = current_time - intro_start_time;
-            double delta_time = current_time - last_time;
-            last_time = current_time;
+        // change title to show a countdown
+        if (time_in_intro >= 3 && time_in_intro < 4) {
+            std::string ready_str = hud->CenterAlignString("Starting in 3...", SMALL_HUD_LEN);
+            title->SetText(ready_str);
+        }
+        else if (time_in_intro >= 4 && time_in_intro < 5) {
+            std::string ready_str = hud->CenterAlignString("Starting in 2...", SMALL_HUD_LEN);
+            title->SetText(ready_str);
+        }
+        else if (time_in_intro >= 5) {
+            std::string ready_str = hud->CenterAlignString("Starting in 1...", SMALL_HUD_LEN);
+            title->SetText(ready_str);
+        }
 
-            // change title to show a countdown
-            if (time_in_intro >= 3 && time_in_intro < 4) {
-                std::string ready_str = hud->CenterAlignString("Starting in 3...", SMALL_HUD_LEN);
-                title->SetText(ready_str);
-            }
-            else if (time_in_intro >= 4 && time_in_intro < 5) {
-                std::string ready_str = hud->CenterAlignString("Starting in 2...", SMALL_HUD_LEN);
-                title->SetText(ready_str);
-            }
-            else if (time_in_intro >= 5) {
-                std::string ready_str = hud->CenterAlignString("Starting in 1...", SMALL_HUD_LEN);
-                title->SetText(ready_str);
-            }
+        // intro is done, so handle accordingly and let the game run
+        if (intro_timer.Finished()) {
+            playing_intro = false;
+            update_flag = true;
+            hud->SetHide(false);
+            title->SetText(" ");
+            am.PlaySound(bg_music);
+        }
+    }
 
-            // from MainLoop()
-            glfwPollEvents();
-            HandleControls(delta_time);
-            Render();
-            glfwSwapBuffers(window_);
 
-            // enforce fps cap
-            if (FPS_CAP != 0) {
-                while (1 / delta_time > FPS_CAP) {
-                    delta_time = glfwGetTime() - last_time;
+    /*** Loops during gameplay, handles window events and drawing while the simulation runs on its own thread ***/
+    void Game::MainLoop(void) {
+
+        // Start simulating
+        simulation_running = true;
+        simulation_thread = std::thread(&Game::SimulationLoop, this);
+
+        try {
+            // Loop while the user did not close the window
+            double last_time = glfwGetTime();
+            double recent_frame_time = 0.0;
+            while (!glfwWindowShouldClose(window_)) {
+
+                // Calculate delta time, the spread of these is the frame pacing
+                double current_time = glfwGetTime();
+                double delta_time = current_time - last_time;
+                last_time = current_time;
+                profiler.Record(PROFILE_FRAME, delta_time);
+
+                // Track hitches, frames well over the recent average, which doesn't follow the hitches themselves
+                if (recent_frame_time == 0.0) {
+                    recent_frame_time = delta_time;
+                }
+                else if (delta_time > std::max((double)HITCH_MIN_TIME, HITCH_FACTOR * recent_frame_time)) {
+                    profiler.RecordHitch(delta_time);
+                    if (PRINT_PROFILE) {
+                        std::cout << "Hitch: " << delta_time * 1000.0 << "ms frame at " << current_time << "s" << std::endl;
+                    }
+                }
+                else {
+                    recent_frame_time += (delta_time - recent_frame_time) * HITCH_AVERAGE_WEIGHT;
+                }
+
+                // Update window events like input handling, then pass the input on
+                glfwPollEvents();
+                PollInput();
+
+                // Render the newest snapshot, the same one is drawn again if the simulation is behind
+                const RenderSnapshot* snapshot = snapshots.Acquire();
+                sprite_stream_.BeginFrame();
+                Render(snapshot);
+                sprite_stream_.EndFrame();
+                double render_end = glfwGetTime();
+                profiler.Record(PROFILE_RENDER, render_end - current_time);
+
+                // Push buffer drawn in the background onto the display
+                glfwSwapBuffers(window_);
+                double present_end = glfwGetTime();
+                profiler.Record(PROFILE_PRESENT, present_end - render_end);
+                if (snapshot) {
+                    profiler.Record(PROFILE_INPUT_LATENCY, present_end - snapshot->input_time);
+                }
+
+                // Warm up once the intro is on screen, and leave the time it took out of the next frame
+                if (!pipeline_warm && snapshot) {
+                    PrewarmPipeline();
+                    pipeline_warm = true;
+                    last_time = glfwGetTime();
+                }
+
+                // Roll the profiler over
+                if (profile_timer.Finished()) {
+                    profiler.EndWindow();
+                    if (PRINT_PROFILE) {
+                        profiler.Print(std::cout);
+                    }
+                    profile_timer.Start(PROFILE_WINDOW);
+                }
+
+                // Enforce FPS cap
+                if (FPS_CAP != 0) {
+                    while (1 / delta_time > FPS_CAP) {
+                        delta_time = glfwGetTime() - last_time;
+                    }
                 }
             }
         }
+        catch (...) {
+            StopSimulation();
+            throw;
+        }
+
+        // Wait for the simulation to finish its frame, and pass on anything it threw
+        StopSimulation();
+        if (simulation_error) {
+            std::rethrow_exception(simulation_error);
+        }
 
-        // intro is done, so handle accordingly and run MainLoop (specified in main.cpp)
-        update_flag = true;
-        hud->SetHide(false);
-        title->SetText(" ");
-        am.PlaySound(bg_music);
+        // Sum up the hitches over the whole run, the windows only show the ones since the last print
+        if (PRINT_PROFILE) {
+            std::cout << "Hitches this run: " << profiler.GetHitchCount() << std::endl;
+        }
     }
 
 
-    /*** Loops during gameplay ***/
-    void Game::MainLoop(void) {
+    /*** Simulation thread, updates the game and publishes a snapshot of it every frame ***/
+    void Game::SimulationLoop(void) {
+        try {
+            double last_time = glfwGetTime();
+            while (simulation_running) {
 
-        // Loop while the user did not close the window
-        double last_time = glfwGetTime();
-        while (!glfwWindowShouldClose(window_)) {
+                // Check for game over
+                if (close_window_timer.Finished()) { GameOver(); }
 
-            // Check for game over
-            if (close_window_timer.Finished()) { GameOver(); }
+                // Calculate delta time
+                double current_time = glfwGetTime();
+                double delta_time = current_time - last_time;
+                last_time = current_time;
 
-            // Calculate delta time
-            double current_time = glfwGetTime();
-            double delta_time = current_time - last_time;
-            last_time = current_time;
+                // Take the newest input from the main thread
+                {
+                    std::lock_guard<std::mutex> lock(input_mutex);
+                    input = latest_input;
+                }
 
-            // Update window events like input handling
-            glfwPollEvents();
+                // Nothing moves during the intro, the controls only let the player quit
+                if (playing_intro) {
+                    HandleControls(delta_time);
+                    UpdateIntro();
+                }
+                else {
+                    // Update the cursor position
+                    UpdateCursorPosition();
 
-            // Update the cursor position
-            UpdateCursorPosition();
+                    // Handle user input
+                    HandleControls(delta_time);
 
-            // Handle user input
-            HandleControls(delta_time);
+                    // Update all the game objects
+                    Update(delta_time);
 
-            // Update all the game objects
-            Update(delta_time);
+                    // Pick up any edits to the wave file
+                    if (wave_reload_timer.Finished()) {
+                        waves.ReloadIfChanged();
+                        wave_reload_timer.Start(WAVE_RELOAD_INTERVAL);
+                    }
 
-            // Spawn Enemies
-            if (update_flag && enemy_arr.size() < MAX_ENEMIES) {
-                if (enemy_spawn_timer.Finished()) {
-                    SpawnEnemy();
-                    enemy_spawn_timer.Start(ENEMY_SPAWN_DELAY);
+                    // Spawn Enemies
+                    if (update_flag && (int)enemy_arr.size() < waves.GetMaxEnemies()) {
+                        if (enemy_spawn_timer.Finished()) {
+                            SpawnEnemyBatch();
+                            enemy_spawn_timer.Start(waves.GetSpawnDelay());
+                        }
+                    }
                 }
-            }
-
-            // Render all the game objects
-            Render();
 
-            // Push buffer drawn in the background onto the display
-            glfwSwapBuffers(window_);
+                // Hand the finished frame to the main thread
+                PublishSnapshot();
+                profiler.Record(PROFILE_SIMULATION, glfwGetTime() - current_time);
 
-            // Enforce FPS cap
-            if (FPS_CAP != 0) {
-                while (1 / delta_time > FPS_CAP) {
-                    delta_time = glfwGetTime() - last_time;
+                // Enforce FPS cap, yielding so the worker threads get the cores
+                if (FPS_CAP != 0) {
+                    while (1 / delta_time > FPS_CAP && simulation_running) {
+                        std::this_thread::yield();
+                        delta_time = glfwGetTime() - last_time;
+                    }
                 }
             }
         }
+        catch (...) {
+            // close the window so the main thread stops and rethrows this
+            simulation_error = std::current_exception();
+            glfwSetWindowShouldClose(window_, true);
+        }
+    }
+
+
+    /*** Stop the simulation thread and wait for it to exit ***/
+    void Game::StopSimulation(void) {
+        simulation_running = false;
+        if (simulation_thread.joinable()) {
+            simulation_thread.join();
+        }
+    }
+
+
+    /*** Read the input the simulation uses, GLFW only allows this on the main thread ***/
+    void Game::PollInput(void) {
+        InputState state;
+
+        // keys (W, A, S, D, F, ESC, K) and mouse buttons (LEFT-CLICK)
+        state.up = glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS;
+        state.down = glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS;
+        state.left = glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS;
+        state.right = glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS;
+        state.shoot = glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+        state.interact = glfwGetKey(window_, GLFW_KEY_F) == GLFW_PRESS;
+        state.quit = glfwGetKey(window_, GLFW_KEY_ESCAPE) == GLFW_PRESS;
+        state.debug_kill = glfwGetKey(window_, GLFW_KEY_K) == GLFW_PRESS;
+
+        // cursor, and the window size needed to map it into the world
+        glfwGetCursorPos(window_, &state.cursor_x, &state.cursor_y);
+        state.window_width = window_width_;
+        state.window_height = window_height_;
+        state.poll_time = glfwGetTime();
+
+        std::lock_guard<std::mutex> lock(input_mutex);
+        latest_input = state;
     }
 
 
@@ -624,7 +791,7 @@ namespace game {
     void Game::HandleControls(double delta_time) {
 
         // Handle exiting the game (keys: ESC)
-        if (glfwGetKey(window_, GLFW_KEY_ESCAPE) == 1) {
+        if (input.quit) {
             glfwSetWindowShouldClose(window_, true);
         }
 
@@ -638,21 +805,21 @@ namespace game {
             float player_accel = player->GetAccelForce();
 
             // Handle physics-based movement input (keys: W, A, S, D)
-            if (glfwGetKey(window_, GLFW_KEY_W) == 1) {
+            if (input.up) {
                 accel += up * player_accel;
             }
-            if (glfwGetKey(window_, GLFW_KEY_S) == 1) {
+            if (input.down) {
                 accel -= up * player_accel;
             }
-            if (glfwGetKey(window_, GLFW_KEY_A) == 1) {
+            if (input.left) {
                 accel += left * player_accel;
             }
-            if (glfwGetKey(window_, GLFW_KEY_D) == 1) {
+            if (input.right) {
                 accel -= left * player_accel;
             }
 
             // Handle firing a bullet (mouse: LEFT-CLICK)
-            if (glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_LEFT) == 1) {
+            if (input.shoot) {
                 if (!holding_shoot && firing_cooldown.Finished()) {
 
                     Weapon* weapon = player->GetWeapon();
@@ -672,7 +839,7 @@ namespace game {
             }
 
             // Handle the interact key (key: F)
-            if (glfwGetKey(window_, GLFW_KEY_F) == 1) {
+            if (input.interact) {
                 if (!holding_interact) {
                     if (interact_id >= 1) {
                         HandlePlayerPurchase();
@@ -690,7 +857,7 @@ namespace game {
             player->SetAcceleration(accel);
 
             // Debug, kills the player instantly (keys: K)
-            if (glfwGetKey(window_, GLFW_KEY_K) == 1) {
+            if (input.debug_kill) {
                 KillPlayer();
             }
         }
@@ -776,17 +943,17 @@ namespace game {
     void Game::UpdateCursorPosition(void) {
 
         // initialize cursor position (relative to monitor) and window size
-        double mouse_x, mouse_y;
-        glfwGetCursorPos(window_, &mouse_x, &mouse_y);
+        double mouse_x = input.cursor_x;
+        double mouse_y = input.cursor_y;
 
         // bounds check, abort if the mouse is outside the window
-        if (mouse_x < 0 || mouse_x > window_width_ || mouse_y < 0 || mouse_y > window_height_) {
+        if (mouse_x < 0 || mouse_x > input.window_width || mouse_y < 0 || mouse_y > input.window_height) {
             return;
         }
 
         // cast width/height to float and initialize cursor position (relative to game world)
-        float width = static_cast<float>(window_width_);
-        float height = static_cast<float>(window_height_);
+        float width = static_cast<float>(input.window_width);
+        float height = static_cast<float>(input.window_height);
 
         // case 1: handle horizontal aspect ratio
         if (width >= height) {
@@ -810,18 +977,25 @@ namespace game {
     /*** Update all the game objects, can change order by re-arranging functions ***/
     void Game::Update(double delta_time) {
 
+        // store-wide systems, timers that came due fire (only those are touched) then linear movers are moved
+        timers.Advance(delta_time);
+        jobs.ParallelFor(entities.GetCount(), ENTITY_MOTION_CHUNK, [this, delta_time](int begin, int end, int thread_index) {
+            entities.IntegrateMotion(begin, end, delta_time);
+        });
+
         // visuals
         UpdateCamera(delta_time);
-        vignette->SetPosition(player->GetPosition());
+        world->Stream(camera_pos);
         title->SetPosition(camera_pos + title_offset);
         win_image->SetPosition(camera_pos + win_image_offset);
 
         // player
         UpdatePlayer(delta_time);
 
-        // fixed areas (enemy spawn portals, buy areas)
-        for (int i = 0; i < enemy_spawn_arr.size(); ++i) {
-            enemy_spawn_arr[i]->Update(delta_time);
+        // fixed areas (enemy spawn portals in the loaded chunks, buy areas)
+        const std::vector<EnemySpawn*>& portals = world->GetPortals();
+        for (int i = 0; i < portals.size(); ++i) {
+            portals[i]->Update(delta_time);
         }
         UpdateBuyables(delta_time);
 
@@ -837,13 +1011,18 @@ namespace game {
             ParticleSystem* ps = particle_system_arr[i];
             ps->Update(delta_time);
             if (ps->EraseTimerCheck()) {
-                particle_system_arr.erase(particle_system_arr.begin() + i);
+                particle_system_arr[i--] = particle_system_arr.back();
+                particle_system_arr.pop_back();
                 delete ps;
             }
         }
 
         // collectibles
         UpdateCollectibles(delta_time);
+
+        // collisions, once everything has moved
+        DetectCollisions();
+        ResolveCollisions();
         
         // heads-up display
         UpdateHUD(delta_time);
@@ -862,22 +1041,10 @@ namespace game {
         camera_target_pos = player->GetPosition();
         glm::vec3 lerp_camera_pos = glm::mix(camera_pos, camera_target_pos, CAMERA_SMOOTHNESS);
 
-        // calculate viewport-related variables
-        float viewport_width = 2.0f * CAMERA_X_BOUND * CAMERA_ZOOM;
-        float viewport_height = 2.0f * CAMERA_Y_BOUND * CAMERA_ZOOM;
-
-        // adjust the viewport based on aspect ratio
-        float aspect_ratio = static_cast<float>(window_width_) / window_height_;
-        if (aspect_ratio > 1.0f) {
-            viewport_width *= aspect_ratio;
-        }
-        else {
-            viewport_height /= aspect_ratio;
-        }
-
-        // calculate dynamic bounds based on adjusted viewport
-        float dynamic_x_bound = (WORLD_SIZE - viewport_width) * 0.5f;
-        float dynamic_y_bound = (WORLD_SIZE - viewport_height) * 0.5f;
+        // calculate dynamic bounds based on the viewport
+        glm::vec2 viewport = GetViewportSize();
+        float dynamic_x_bound = (world->GetSize() - viewport.x) * 0.5f;
+        float dynamic_y_bound = (world->GetSize() - viewport.y) * 0.5f;
 
         // ensure bounds don't go negative (if viewport is larger than world)
         dynamic_x_bound = glm::max(dynamic_x_bound, 0.0f);
@@ -887,6 +1054,23 @@ namespace game {
         camera_pos.x = glm::clamp(lerp_camera_pos.x, -dynamic_x_bound, dynamic_x_bound);
         camera_pos.y = glm::clamp(lerp_camera_pos.y, -dynamic_y_bound, dynamic_y_bound);
 
+        // the player hears the world from wherever the camera is
+        am.SetListenerPosition(camera_pos.x, camera_pos.y, 0.0);
+    }
+
+
+    /*** Size of the area the camera shows in world units, widened or heightened by the aspect ratio ***/
+    glm::vec2 Game::GetViewportSize(void) const {
+        glm::vec2 viewport(2.0f * CAMERA_X_BOUND * CAMERA_ZOOM, 2.0f * CAMERA_Y_BOUND * CAMERA_ZOOM);
+
+        float aspect_ratio = static_cast<float>(input.window_width) / input.window_height;
+        if (aspect_ratio > 1.0f) {
+            viewport.x *= aspect_ratio;
+        }
+        else {
+            viewport.y /= aspect_ratio;
+        }
+        return viewport;
     }
 
 
@@ -902,7 +1086,6 @@ namespace game {
                 player->UpdateTargetAngle(atan2(direction.y, direction.x) - (HALF_PI));
 
                 player->Update(delta_time);
-                PlayerShotCheck(delta_time);
             }
         }
         else if (player->EraseTimerCheck()) {
@@ -941,61 +1124,92 @@ namespace game {
 
     /*** Update all the enemy game objects, ensures intended behavior every frame ***/
     void Game::UpdateEnemies(double delta_time) {
+
+        // remove finished explosions and explode the dead, both touch shared state so run serially
         for (int i = 0; i < enemy_arr.size(); ++i) {
             EnemyGameObject* enemy = enemy_arr[i];
 
-            // Kamikaze D.O.T effect
-            if (KamikazeEnemy* kamikaze = dynamic_cast<KamikazeEnemy*>(enemy)) {
-                if (kamikaze->IsExplosionActive()) {
-                    float dist = glm::length(player->GetPosition() - enemy->GetPosition());
-                    if (dist < kamikaze->GetExplosionRadius()) {
-                        player->TakeDamage(2); // or scale with delta_time for DoT
-                    }
-                }
-            }
-
+            // order doesn't matter, so fill the hole with the last enemy and revisit this slot
             if (enemy->EraseTimerCheck()) {
-                enemy_arr.erase(enemy_arr.begin() + i);
+                enemy_arr[i--] = enemy_arr.back();
+                enemy_arr.pop_back();
                 delete enemy;
             }
+            else if (!enemy->IsExploded() && enemy->GetHealth() <= 0) {
+                ExplodeEnemy(enemy);
+            }
+        }
 
-            // skip most updates if the enemy has exploded
-            else if (!enemy->IsExploded()) {
+        // enemies only read the player, so movement and targeting can run on every core
+        double enemy_delta_time = player->IsColdShockActive() ? delta_time / 2.5 : delta_time;
+        enemy_timers.Advance(enemy_delta_time);
+        jobs.ParallelFor(enemy_arr.size(), ENEMY_UPDATE_CHUNK, [this, enemy_delta_time](int begin, int end, int thread_index) {
+            std::vector<EnemyEvent>& events = enemy_events[thread_index];
 
-                // check if the enemy has died
-                if (enemy->GetHealth() <= 0) {
-                    ExplodeEnemy(enemy);
-                }
-                else {
+            for (int i = begin; i < end; ++i) {
+                EnemyGameObject* enemy = enemy_arr[i];
 
-                    // if not dead, update according to the cold_shock flag
-                    if (player->IsColdShockActive()) {
-                        enemy->Update(delta_time / 2.5);
-                    }
-                    else {
-                        enemy->Update(delta_time);
+                // Kamikaze D.O.T effect
+                if (enemy->GetType() == ENEMY_KAMIKAZE) {
+                    KamikazeEnemy* kamikaze = static_cast<KamikazeEnemy*>(enemy);
+                    if (kamikaze->IsExplosionActive()) {
+                        float dist = glm::length(player->GetPosition() - enemy->GetPosition());
+                        if (dist < kamikaze->GetExplosionRadius()) {
+                            events.push_back({ KAMIKAZE_BURN, i });
+                        }
                     }
+                }
+
+                // skip the rest if the enemy has exploded
+                if (enemy->IsExploded()) {
+                    continue;
+                }
+
+                // update according to the cold_shock flag, far enemies skip most frames and don't steer on those
+                float dist_to_player = glm::distance(enemy->GetPosition(), player->GetPosition());
+                if (!enemy->UpdateWithDetail(enemy_delta_time, dist_to_player)) {
+                    continue;
+                }
 
-                    // misc updates to be called if the player is alive
-                    if (update_flag) {
+                // misc updates to be called if the player is alive
+                if (update_flag) {
 
-                        // check for gunner, only shoot if player is in range
-                        if (GunnerEnemy* gunner = dynamic_cast<GunnerEnemy*>(enemy)) {
-                            if (glm::distance(gunner->GetPosition(), player->GetPosition())
-                                < GUNNER_SHOOT_DIST) {
+                    // check for gunner, only shoot if player is in range
+                    if (enemy->GetType() == ENEMY_GUNNER) {
+                        GunnerEnemy* gunner = static_cast<GunnerEnemy*>(enemy);
+                        if (glm::distance(gunner->GetPosition(), player->GetPosition())
+                            < GUNNER_SHOOT_DIST) {
 
-                                if (gunner->IsShootCDFinished()) {
-                                    SpawnGunnerBullet(gunner);
-                                }
+                            if (gunner->IsShootReady()) {
+                                events.push_back({ GUNNER_SHOOT, i });
                             }
                         }
-                        enemy->UpdateTarget(player);
-                        EnemyShotCheck(enemy, delta_time);
-                        EnemyCollisionCheck(enemy);
                     }
+                    enemy->UpdateTarget(player);
                 }
             }
+        });
+
+        // apply the side effects in enemy order, so the result doesn't depend on how the work was split
+        std::vector<EnemyEvent>& merged = enemy_events[0];
+        for (int t = 1; t < enemy_events.size(); ++t) {
+            merged.insert(merged.end(), enemy_events[t].begin(), enemy_events[t].end());
+            enemy_events[t].clear();
+        }
+        std::sort(merged.begin(), merged.end(), [](const EnemyEvent& a, const EnemyEvent& b) {
+            return a.enemy_index < b.enemy_index;
+        });
+        for (int i = 0; i < merged.size(); ++i) {
+            if (merged[i].type == KAMIKAZE_BURN) {
+                player->TakeDamage(2); // or scale with delta_time for DoT
+            }
+            else {
+                GunnerEnemy* gunner = static_cast<GunnerEnemy*>(enemy_arr[merged[i].enemy_index]);
+                gunner->StartShootCooldown();
+                SpawnGunnerBullet(gunner);
+            }
         }
+        merged.clear();
     }
 
 
@@ -1007,7 +1221,8 @@ namespace game {
             bullet->Update(delta_time);
 
             if (bullet->EraseTimerCheck()) {
-                projectile_arr.erase(projectile_arr.begin() + i);
+                projectile_arr[i--] = projectile_arr.back();
+                projectile_arr.pop_back();
                 delete bullet;
             }
         }
@@ -1022,7 +1237,8 @@ namespace game {
             bullet->Update(delta_time);
 
             if (bullet->EraseTimerCheck()) {
-                gunner_projectile_arr.erase(gunner_projectile_arr.begin() + i);
+                gunner_projectile_arr[i--] = gunner_projectile_arr.back();
+                gunner_projectile_arr.pop_back();
                 delete bullet;
             }
         }
@@ -1035,20 +1251,13 @@ namespace game {
             CollectibleGameObject* collectible = collectible_arr[i];
 
             if (collectible->EraseTimerCheck()) {
-                collectible_arr.erase(collectible_arr.begin() + i);
+                collectible_arr[i--] = collectible_arr.back();
+                collectible_arr.pop_back();
                 if (!collectible->IsCollected()) {
                     am.StopSound(power_up_ambience);
                 }
                 delete collectible;
             }
-
-            else if (!collectible->IsCollected()) {
-                collectible->Update(delta_time);
-
-                if (CollisionCheck(player, collectible)) {
-                    CollectPowerUp(collectible);
-                }
-            }
         }
     }
 
@@ -1057,17 +1266,9 @@ namespace game {
     void Game::UpdateHUD(double delta_time) {
 
         // calculate corner positions based on window dimensions and camera zoom
-        float world_width = 2.0f * CAMERA_X_BOUND * CAMERA_ZOOM;
-        float world_height = 2.0f * CAMERA_Y_BOUND * CAMERA_ZOOM;
-
-        // adjust for aspect ratio
-        float aspect_ratio = static_cast<float>(window_width_) / window_height_;
-        if (aspect_ratio > 1.0f) {
-            world_width *= aspect_ratio;
-        }
-        else {
-            world_height /= aspect_ratio;
-        }
+        glm::vec2 viewport = GetViewportSize();
+        float world_width = viewport.x;
+        float world_height = viewport.y;
 
         // calculate positions relative to camera
         float rightEdge = camera_pos.x + (world_width * 0.5f) - (HUD_CORNER_MARGIN * 4);
@@ -1090,11 +1291,13 @@ namespace game {
         );
         hud->UpdateHealth(std::to_string(player->GetHealth()));
 
-        // top right corner, fps only, update based on FPS_UPDATE_INTERVAL
+        // top right corner, fps only, update based on FPS_UPDATE_INTERVAL.
+        // Shows presented frames, which the simulation rate no longer matches
         hud->SetTopRightCorner(glm::vec3(rightEdge, topEdge, 0.0f));
-        if (delta_time > 0 && update_fps_timer.Finished()) {
+        double frame_time = profiler.GetAverage(PROFILE_FRAME);
+        if (frame_time > 0 && update_fps_timer.Finished()) {
             update_fps_timer.Start(FPS_UPDATE_INTERVAL);
-            int fps = std::floor(1 / delta_time);
+            int fps = std::floor(1 / frame_time);
             if (FPS_CAP != 0 && fps > FPS_CAP) {
                 fps = FPS_CAP;
             }
@@ -1114,21 +1317,163 @@ namespace game {
     /**********************************/
 
 
-    /*** Check for collisions with the param enemy ***/
-    void Game::EnemyCollisionCheck(EnemyGameObject* enemy) {
-        if (ChaserEnemy* chaser = dynamic_cast<ChaserEnemy*>(enemy)) {
-            if (CollisionCheck(player, chaser->GetChild1()) || CollisionCheck(player, chaser->GetChild2()) || CollisionCheck(player, chaser->GetChild3())) {
+    /*** Find this frame's collisions, only records contacts so it can run on every core ***/
+    void Game::DetectCollisions(void) {
+
+        // broad-phase, bucket the live enemies by grid cell around the player
+        enemy_grid.Clear();
+        enemy_grid.SetCenter(player->GetPosition());
+        for (int i = 0; i < enemy_arr.size(); ++i) {
+            EnemyGameObject* enemy = enemy_arr[i];
+            if (!enemy->IsExploded() && enemy->GetHealth() > 0) {
+                enemy_grid.Insert(i, enemy->GetPosition());
+            }
+        }
+        enemy_grid.Finalize();
+
+        // enemies and their bullets only collide while the player is alive
+        if (update_flag) {
+
+            // player bullets against nearby enemies, every overlap is a contact so a bullet whose first
+            // enemy dies earlier in the resolve can still hit the next live one
+            jobs.ParallelFor(projectile_arr.size(), BULLET_COLLISION_CHUNK, [this](int begin, int end, int thread_index) {
+                std::vector<Contact>& found = contacts[thread_index];
+
+                for (int b = begin; b < end; ++b) {
+                    ProjectileGameObject* bullet = projectile_arr[b];
+                    if (bullet->GetImpact()) {
+                        continue;
+                    }
+
+                    enemy_grid.ForEachNear(bullet->GetPosition(), COLLISION_QUERY_RADIUS, [&](int e) {
+                        EnemyGameObject* enemy = enemy_arr[e];
+                        if (RayCircleCheck(bullet, enemy, enemy->GetXRadius() + BULLET_RADIUS)) {
+                            found.push_back({ CONTACT_PLAYER_BULLET, b, e });
+                        }
+                    });
+                }
+            });
+
+            // gunner bullets against the player
+            float collision_dist = player->GetXRadius() + BULLET_RADIUS;
+            for (int i = 0; i < gunner_projectile_arr.size(); ++i) {
+                ProjectileGameObject* bullet = gunner_projectile_arr[i];
+                if (!bullet->GetImpact() && RayCircleCheck(bullet, player, collision_dist)) {
+                    contacts[0].push_back({ CONTACT_GUNNER_BULLET, i, 0 });
+                }
+            }
+
+            // enemy bodies and chaser arms near the player
+            enemy_grid.ForEachNear(player->GetPosition(), COLLISION_QUERY_RADIUS + CHASER_ARM_REACH, [this](int e) {
+                EnemyGameObject* enemy = enemy_arr[e];
+                if (enemy->GetType() == ENEMY_CHASER) {
+                    ChaserEnemy* chaser = static_cast<ChaserEnemy*>(enemy);
+                    if (CollisionCheck(player, chaser->GetChild1()) || CollisionCheck(player, chaser->GetChild2()) || CollisionCheck(player, chaser->GetChild3())) {
+                        contacts[0].push_back({ CONTACT_CHASER_ARM, e, 0 });
+                    }
+                }
+                if (CollisionCheck(player, enemy)) {
+                    contacts[0].push_back({ CONTACT_ENEMY_BODY, e, 0 });
+                }
+            });
+        }
+
+        // power-ups the player is touching
+        for (int i = 0; i < collectible_arr.size(); ++i) {
+            CollectibleGameObject* collectible = collectible_arr[i];
+            if (!collectible->IsCollected() && CollisionCheck(player, collectible)) {
+                contacts[0].push_back({ CONTACT_COLLECTIBLE, i, 0 });
+            }
+        }
+    }
+
+
+    /*** Apply the contacts one at a time, in the same order no matter which thread found them ***/
+    void Game::ResolveCollisions(void) {
+        std::vector<Contact>& merged = contacts[0];
+        for (int t = 1; t < contacts.size(); ++t) {
+            merged.insert(merged.end(), contacts[t].begin(), contacts[t].end());
+            contacts[t].clear();
+        }
+        std::sort(merged.begin(), merged.end(), [](const Contact& a, const Contact& b) {
+            if (a.type != b.type) return a.type < b.type;
+            if (a.first != b.first) return a.first < b.first;
+            return a.second < b.second;
+        });
+
+        for (int i = 0; i < merged.size(); ++i) {
+            const Contact& contact = merged[i];
+
+            switch (contact.type) {
+
+            case CONTACT_GUNNER_BULLET: {
+                ProjectileGameObject* bullet = gunner_projectile_arr[contact.first];
+                bullet->ImpactOccured();
+                if (player->TakeDamage(bullet->GetDamage())) {
+                    am.PlaySound(player_hit_sfx);
+                }
+                break;
+            }
+
+            case CONTACT_PLAYER_BULLET: {
+                // a bullet's contacts come in enemy order, it hits the first one still alive and skips the rest
+                ProjectileGameObject* bullet = projectile_arr[contact.first];
+                EnemyGameObject* enemy = enemy_arr[contact.second];
+                if (bullet->GetImpact() || enemy->IsExploded() || enemy->GetHealth() <= 0) {
+                    break;
+                }
+
+                bullet->ImpactOccured();
+                enemy->TakeDamage(player->GetDamage());
+                glm::vec3 enemy_pos = enemy->GetPosition();
+                am.PlaySoundAt(enemy_hit_sfx, enemy_pos.x, enemy_pos.y, 0.0);
+
+                // enemy not alive, big point reward (assigned per enemy)
+                if (enemy->GetHealth() <= 0) {
+                    player->AddPoints(enemy->GetPointReward());
+                    ExplodeEnemy(enemy);
+                }
+
+                // enemy still alive, small point reward
+                else {
+                    player->AddPoints(SHOT_HIT_POINT_REWARD);
+                }
+                break;
+            }
+
+            case CONTACT_CHASER_ARM: {
+                EnemyGameObject* chaser = enemy_arr[contact.first];
+                if (chaser->IsExploded() || chaser->GetHealth() <= 0) {
+                    break;
+                }
                 glm::vec3 direction = glm::normalize(player->GetPosition() - chaser->GetPosition());
-                player->ApplyKnockback(direction * 10.0f, chaser->GetDamage());
-                // std::cout << "collided with arm segment" << std::endl;
+                glm::vec3 knockback = direction * 10.0f;
+                player->ApplyKnockback(knockback, chaser->GetDamage());
                 player->GetKnockbackCooldown().Start(1.0f);
+                break;
+            }
+
+            case CONTACT_ENEMY_BODY: {
+                EnemyGameObject* enemy = enemy_arr[contact.first];
+                if (enemy->IsExploded() || enemy->GetHealth() <= 0) {
+                    break;
+                }
+                enemy->TakeDamage(enemy->GetHealth());
+                player->TakeDamage(enemy->GetDamage());
+                am.PlaySound(player_hit_sfx);
+                break;
+            }
+
+            case CONTACT_COLLECTIBLE: {
+                CollectibleGameObject* collectible = collectible_arr[contact.first];
+                if (!collectible->IsCollected()) {
+                    CollectPowerUp(collectible);
+                }
+                break;
+            }
             }
         }
-        if (enemy && CollisionCheck(player, enemy)) {
-            enemy->TakeDamage(enemy->GetHealth());
-            player->TakeDamage(enemy->GetDamage());
-            am.PlaySound(player_hit_sfx);
-        }
+        merged.clear();
     }
 
 
@@ -1136,7 +1481,8 @@ namespace game {
     void Game::ExplodeEnemy(EnemyGameObject* enemy) {
 
         // change enemy properties to show it has exploded
-        if (ChaserEnemy* chaser = dynamic_cast<ChaserEnemy*>(enemy)) {
+        if (enemy->GetType() == ENEMY_CHASER) {
+            ChaserEnemy* chaser = static_cast<ChaserEnemy*>(enemy);
             chaser->GetChild1()->SetScale(glm::vec2(0.0f));
             chaser->GetChild2()->SetScale(glm::vec2(0.0f));
             chaser->GetChild3()->SetScale(glm::vec2(0.0f));
@@ -1144,7 +1490,8 @@ namespace game {
             enemy->SetScale(glm::vec2(1.8f));
         }
         // handle kamikaze explosion so as to activate the explosion and set it to a different texture
-        else if (KamikazeEnemy* kamikaze = dynamic_cast<KamikazeEnemy*>(enemy)) {
+        else if (enemy->GetType() == ENEMY_KAMIKAZE) {
+            KamikazeEnemy* kamikaze = static_cast<KamikazeEnemy*>(enemy);
             kamikaze->SetDamage(0);
             enemy->SetTexture(tex_[28]);
             enemy->SetScale(glm::vec2(3.0f));
@@ -1159,15 +1506,15 @@ namespace game {
         enemy->Explode();
         enemy->StartEraseTimer();
 
-        // play explosion sound
-        am.PlaySound(boom_sfx);
+        // play explosion sound where the enemy was
+        glm::vec3 enemy_pos = enemy->GetPosition();
+        am.PlaySoundAt(boom_sfx, enemy_pos.x, enemy_pos.y, 0.0);
 
         // use RNG to decide if a power-up should spawn
-        std::mt19937 gen(rd());
         std::uniform_real_distribution<> dis(0.0f, 1.0f);
 
         // spawn if RNG gives a number less than the spawn chance
-        if (dis(gen) <= POWER_UP_SPAWN_CHANCE) {
+        if (dis(rng) <= POWER_UP_SPAWN_CHANCE) {
             SpawnCollectible(enemy);
         }
 
@@ -1176,56 +1523,6 @@ namespace game {
     }
 
 
-    /*** Check for ray-circle collision between an enemy and player-shot bullets ***/
-    void Game::EnemyShotCheck(EnemyGameObject* enemy, double delta_time) {
-
-        // check against all non-impacted bullets
-        for (int i = 0; i < projectile_arr.size(); i++) {
-            if (!projectile_arr[i]->GetImpact()) {
-                ProjectileGameObject* bullet = projectile_arr[i];
-                float collision_dist = enemy->GetXRadius() + BULLET_RADIUS;
-
-                // check for ray-circle collision
-                if (RayCircleCheck(bullet, enemy, collision_dist)) {
-                    enemy->TakeDamage(player->GetDamage());
-                    am.PlaySound(enemy_hit_sfx);
-
-                    // enemy not alive, big point reward (assigned per enemy)
-                    if (enemy->GetHealth() <= 0) {
-                        player->AddPoints(enemy->GetPointReward());
-                        ExplodeEnemy(enemy);
-                    }
-
-                    // enemy still alive, small point reward
-                    else {
-                        player->AddPoints(SHOT_HIT_POINT_REWARD);
-                    }
-                }
-            }
-        }
-    }
-
-
-    /*** Check for ray-circle collision between the player and enemy-shot bullets ***/
-    void Game::PlayerShotCheck(double delta_time) {
-        float collision_dist = player->GetXRadius() + BULLET_RADIUS;
-
-        // check against all non-impacted bullets
-        for (int i = 0; i < gunner_projectile_arr.size(); i++) {
-            if (!gunner_projectile_arr[i]->GetImpact()) {
-                ProjectileGameObject* bullet = gunner_projectile_arr[i];
-
-                // check for ray-circle collision
-                if (RayCircleCheck(bullet, player, collision_dist)) {
-                    if (player->TakeDamage(bullet->GetDamage())) {
-                        am.PlaySound(player_hit_sfx);
-                    }
-                }
-            }
-        }
-    }
-
-
     /*** Handle collecting a collectible ***/
     void Game::CollectPowerUp(CollectibleGameObject* collectible) {
         collectible->Collect();
@@ -1256,32 +1553,15 @@ namespace game {
     }
 
 
-    /*** Spawn an enemy on a spawn portal according to the waves ***/
-    void Game::SpawnEnemy(void) {
-
-        // required definitions for function logic
-        std::mt19937 gen(rd());
-        int gunner = 1, chaser = 2, kamikaze = 3;
-        std::vector<int> possible_enemies;
-        EnemyGameObject* new_enemy = nullptr;
-
-        // populate possible_enemies with the enemy types that can be spawned
-        if (waves.GetWave().GetGunnerCount() > 0) {
-            possible_enemies.push_back(gunner);
-        }
-        if (waves.GetWave().GetChaserCount() > 0) {
-            possible_enemies.push_back(chaser);
-        }
-        if (waves.GetWave().GetKamikazeCount() > 0) {
-            possible_enemies.push_back(kamikaze);
-        }
+    /*** Spawn a batch of enemies according to the waves, dealt out across all the spawn portals ***/
+    void Game::SpawnEnemyBatch(void) {
 
         // if there are no more enemies to spawn, increment the wave
         if (waves.EnemiesAlive() <= 0) {
             if (waves.IncrementWave()) {
                 std::cout << "Wave complete." << std::endl;
                 am.PlaySound(wave_complete_sfx);
-                enemy_spawn_timer.Start(2.0f);
+                enemy_spawn_timer.Start(waves.GetWaveDelay());
             }
             else {
                 if (!game_won) {
@@ -1292,69 +1572,84 @@ namespace game {
             return;
         }
 
-        // continue with spawning ONLY IF there are enemies remaining in the Wave object
-        if (possible_enemies.size() > 0) {
-
-            // get coordinates for the spawn based on spawn portals
-            std::uniform_int_distribution<> spawn_dis(0, 7);
-            int spawn_index = spawn_dis(gen);
-            glm::vec3 spawn_pos = enemy_spawn_arr[spawn_index]->GetPosition();
+        // every portal of the player's sector spawns, streaming only limits which of them are drawn and updated
+        const std::vector<glm::vec3>& spawn_points = world->GetSpawnPoints(player->GetPosition());
+        if (spawn_points.empty()) {
+            return;
+        }
 
-            // randomly decide which enemy to spawn based on possible_enemies vector
-            std::uniform_int_distribution<> enemy_dis(0, possible_enemies.size() - 1);
-            int random_enemy_index = possible_enemies[enemy_dis(gen)];
-            switch (random_enemy_index) {
+        // start each batch on a random portal so single spawns stay unpredictable
+        std::uniform_int_distribution<> spawn_dis(0, spawn_points.size() - 1);
+        next_spawn_portal = spawn_dis(rng);
 
-            case 1:
-                // Spawn a Gunner, decrement the corresponding enemy counter
-                new_enemy = new GunnerEnemy(spawn_pos, sprite_, &sprite_shader_, tex_[1]);
-                waves.DecrementEnemyCount(gunner);
+        // stop early if the wave runs out or the enemy cap is hit
+        for (int n = 0; n < waves.GetSpawnBatch() && (int)enemy_arr.size() < waves.GetMaxEnemies(); n++) {
+            if (!SpawnEnemy(spawn_points[next_spawn_portal])) {
                 break;
+            }
+            next_spawn_portal = (next_spawn_portal + 1) % spawn_points.size();
+        }
+    }
 
-            case 2:
-                // Spawn a Chaser, decrement the corresponding enemy counter
-                new_enemy = new ChaserEnemy(spawn_pos, sprite_, &sprite_shader_, tex_[2], tex_[18], tex_[19], tex_[17]);
-                waves.DecrementEnemyCount(chaser);
-                break;
 
-            case 3:
-                // Spawn a Kamikaze, decrement the corresponding enemy counter
-                new_enemy = new KamikazeEnemy(spawn_pos, sprite_, &sprite_shader_, tex_[3]);
-                waves.DecrementEnemyCount(kamikaze);
-                break;
-            }
+    /*** Spawn a single enemy at a spawn portal, returns false if the wave has nothing left to spawn ***/
+    bool Game::SpawnEnemy(const glm::vec3& spawn_pos) {
 
-            // scale enemy health and speed based on current wave
-            if (new_enemy) {
-                if (waves.GetCurrentWave() == 4) {
-                    new_enemy->SetHealthScale(1.2);
-                }
-                else if (waves.GetCurrentWave() == 6) {
-                    new_enemy->SetHealthScale(1.2);
-                    new_enemy->SetSpeedScale(1.05);
-                }
-                else if (waves.GetCurrentWave() == 8) {
-                    new_enemy->SetHealthScale(1.5);
-                    new_enemy->SetSpeedScale(1.1);
-                }
-                else if (waves.GetCurrentWave() == 10) {
-                    new_enemy->SetHealthScale(1.75);
-                    new_enemy->SetSpeedScale(1.2);
-                }
+        // collect the enemy types that can be spawned
+        EnemyType possible_enemies[3];
+        int possible_count = 0;
+        if (waves.GetWave().GetGunnerCount() > 0) {
+            possible_enemies[possible_count++] = ENEMY_GUNNER;
+        }
+        if (waves.GetWave().GetChaserCount() > 0) {
+            possible_enemies[possible_count++] = ENEMY_CHASER;
+        }
+        if (waves.GetWave().GetKamikazeCount() > 0) {
+            possible_enemies[possible_count++] = ENEMY_KAMIKAZE;
+        }
 
-                enemy_arr.push_back(new_enemy);
-            }
+        // continue with spawning ONLY IF there are enemies remaining in the Wave object
+        if (possible_count == 0) {
+            return false;
         }
+
+        // randomly decide which enemy to spawn based on possible_enemies
+        std::uniform_int_distribution<> enemy_dis(0, possible_count - 1);
+        EnemyType enemy_type = possible_enemies[enemy_dis(rng)];
+        EnemyGameObject* new_enemy = nullptr;
+        switch (enemy_type) {
+
+        case ENEMY_GUNNER:
+            new_enemy = new GunnerEnemy(spawn_pos, sprite_, &sprite_shader_, tex_[1]);
+            break;
+
+        case ENEMY_CHASER:
+            new_enemy = new ChaserEnemy(spawn_pos, sprite_, &sprite_shader_, tex_[2], tex_[18], tex_[19], tex_[17]);
+            break;
+
+        default:
+            new_enemy = new KamikazeEnemy(spawn_pos, sprite_, &sprite_shader_, tex_[3]);
+            break;
+        }
+
+        // decrement the corresponding enemy counter
+        waves.DecrementEnemyCount(enemy_type);
+
+        // scale enemy health and speed based on current wave
+        new_enemy->SetHealthScale(waves.GetWave().GetHealthScale());
+        new_enemy->SetSpeedScale(waves.GetWave().GetSpeedScale());
+
+        enemy_arr.push_back(new_enemy);
+        return true;
     }
 
 
     /*** Spawn a collectible, occasionally called when killing an enemy, spawns on their explosion ***/
     void Game::SpawnCollectible(EnemyGameObject* enemy) {
-        std::mt19937 gen(rd()); // RNG setup
 
         // generate a random int to determine which power-up to spawn
         std::uniform_int_distribution<> dis_id(0, 2);
-        int rand_id = dis_id(gen);
+        int rand_id = dis_id(rng);
 
         // setup the new collectible
         CollectibleGameObject* power_up = new CollectibleGameObject(
@@ -1364,7 +1659,7 @@ namespace game {
 
         // generate a random angle, then convert to a vector to be used as velocity
         std::uniform_real_distribution<> dis_angle(0.0f, TWO_PI);
-        float velocity_angle = dis_angle(gen);
+        float velocity_angle = dis_angle(rng);
 
         // give the collectible random velocity
         power_up->SetVelocity(glm::vec3(cos(velocity_angle), sin(velocity_angle), 0.0f));
@@ -1416,11 +1711,9 @@ namespace game {
         particle_system_arr.push_back(bullet_particles);
 
         // randomly generate spread based on the weapon's bullet spread member var
-        std::random_device rd;
-        std::mt19937 gen(rd());
         float spread = weapon->GetBulletSpread();
         std::uniform_real_distribution<> dis_spread(-spread, spread);
-        float random_spread = dis_spread(gen);
+        float random_spread = dis_spread(rng);
 
         // calculate bullet direction with the spread offset
         glm::vec3 direction = glm::normalize(cursor_pos - player_pos);
@@ -1455,20 +1748,21 @@ namespace game {
         bullet->SetVelocity(glm::normalize(aim_line) * GUNNER_BULLET_SPEED);
         bullet->SetRotation(atan2(aim_line.y, aim_line.x) - (HALF_PI));
 
-        // play the corresponding sound effect
-        am.PlaySound(enemy_shoot_sfx);
+        // play the corresponding sound effect from the gunner
+        glm::vec3 gunner_pos = gunner->GetPosition();
+        am.PlaySoundAt(enemy_shoot_sfx, gunner_pos.x, gunner_pos.y, 0.0);
     }
 
 
     /*** Handle Circle-Circle collision checking, only considers radius in the x-axis ***/
-    bool Game::CollisionCheck(GameObject* obj_1, GameObject* obj_2) {
+    bool Game::CollisionCheck(GameObject* obj_1, GameObject* obj_2) const {
         return glm::length(obj_1->GetPosition() - obj_2->GetPosition())
                < obj_1->GetXRadius() + obj_2->GetXRadius();
     }
 
 
     /*** Return true if a Ray-Circle collision is found between a projectile and game object, false otherwise ***/
-    bool Game::RayCircleCheck(ProjectileGameObject* bullet, GameObject* obj, float col_dist) {
+    bool Game::RayCircleCheck(ProjectileGameObject* bullet, GameObject* obj, float col_dist) const {
 
         // perform ray-circle check via quadratic formula re-arrange
         glm::vec3 origin_to_center = bullet->GetOrigin() - obj->GetPosition();
@@ -1486,8 +1780,7 @@ namespace game {
             float lifespan = bullet->GetBulletTimeElapsed();
             if (t1 <= lifespan && lifespan <= t2) {
 
-                // collision confirmed, handle it, then return true
-                bullet->ImpactOccured();
+                // collision confirmed, the caller decides what happens
                 return true;
             }
         }
@@ -1529,7 +1822,7 @@ namespace game {
 
         // audio/visual indication that the player won
         am.PlaySound(win_game_sfx);
-        win_image->SetScale(glm::vec2(6.5f, 5.0f));
+        win_image->Show(glm::vec2(6.5f, 5.0f));
 
         // rank calculation
         int points = player->GetPoints();
@@ -1561,8 +1854,104 @@ namespace game {
     }
 
 
-    /*** Render the Game World ***/
-    void Game::Render(void) {
+    /*** Copy the Game World into a snapshot for the render thread ***/
+    void Game::PublishSnapshot(void) {
+        RenderSnapshot& snapshot = snapshots.BeginWrite();
+        snapshot.camera_pos = camera_pos;
+        snapshot.vignette_center = player->GetPosition();
+        snapshot.input_time = input.poll_time;
+
+        // view rect for culling, the same area UpdateCamera and UpdateHUD work from
+        glm::vec2 half_view = GetViewportSize() * 0.5f;
+        view_min = glm::vec2(camera_pos) - half_view;
+        view_max = glm::vec2(camera_pos) + half_view;
+        drawn_count = 0;
+        culled_count = 0;
+
+        /* Add the visible GameObjects in storage (order: back to front) */
+
+        // Background, the starfield is drawn by Render and only the loaded chunks' portals are candidates
+        const std::vector<EnemySpawn*>& portals = world->GetPortals();
+        for (int i = 0; i < portals.size(); ++i) {
+            AddIfVisible(snapshot, portals[i], LAYER_BACKGROUND);
+        }
+
+        AddIfVisible(snapshot, win_image, LAYER_BACKGROUND);
+
+        for (int i = 0; i < buyable_arr.size(); ++i) {
+            AddIfVisible(snapshot, buyable_arr[i], LAYER_BACKGROUND);
+            AddIfVisible(snapshot, buyable_arr[i]->GetIcon(), LAYER_BACKGROUND);
+        }
+
+        // Foreground, particle systems are placed by their parent and skipped once it's gone
+        for (int i = 0; i < particle_system_arr.size(); i++) {
+            ParticleSystem* ps = particle_system_arr[i];
+            if (ps->IsHidden() || !ps->HasVisibleParent()) {
+                culled_count++;
+            }
+            else if (!IsInView(ps->GetParent()->GetPosition(), PARTICLE_CULL_RADIUS)) {
+                culled_count++;
+            }
+            else {
+                ps->AddToSnapshot(snapshot, LAYER_FOREGROUND);
+                drawn_count++;
+            }
+        }
+
+        for (int i = 0; i < gunner_projectile_arr.size(); ++i) {
+            AddIfVisible(snapshot, gunner_projectile_arr[i], LAYER_FOREGROUND);
+        }
+
+        for (int i = 0; i < projectile_arr.size(); ++i) {
+            AddIfVisible(snapshot, projectile_arr[i], LAYER_FOREGROUND);
+        }
+
+        for (int i = 0; i < collectible_arr.size(); ++i) {
+            AddIfVisible(snapshot, collectible_arr[i], LAYER_FOREGROUND);
+        }
+
+        // chasers draw their arms too, which reach past the body
+        for (int i = 0; i < enemy_arr.size(); ++i) {
+            EnemyGameObject* enemy = enemy_arr[i];
+            AddIfVisible(snapshot, enemy, LAYER_FOREGROUND, enemy->GetType() == ENEMY_CHASER ? CHASER_ARM_REACH : 0.0f);
+        }
+
+        player->AddToSnapshot(snapshot, LAYER_FOREGROUND);
+
+        // Overlays, the vignette is drawn by Render around vignette_center
+        title->AddToSnapshot(snapshot, LAYER_HUD);
+
+        hud->AddToSnapshot(snapshot);
+
+        profiler.RecordCount(COUNT_DRAWN, drawn_count);
+        profiler.RecordCount(COUNT_CULLED, culled_count);
+        profiler.RecordCount(COUNT_AUDIO_DROPPED, am.TakeDroppedCommands());
+
+        snapshot.publish_time = glfwGetTime();
+        snapshots.Publish();
+    }
+
+
+    /*** Check if a circle overlaps the view rect ***/
+    bool Game::IsInView(const glm::vec3& position, float radius) const {
+        return position.x + radius >= view_min.x && position.x - radius <= view_max.x
+            && position.y + radius >= view_min.y && position.y - radius <= view_max.y;
+    }
+
+
+    /*** Add an object to the snapshot unless it's hidden or entirely off-screen, margin covers parts drawn past its scale ***/
+    void Game::AddIfVisible(RenderSnapshot& snapshot, const GameObject* obj, SnapshotLayer layer, float margin) {
+        if (obj->IsHidden() || !IsInView(obj->GetPosition(), obj->GetBoundingRadius() + margin)) {
+            culled_count++;
+            return;
+        }
+        obj->AddToSnapshot(snapshot, layer);
+        drawn_count++;
+    }
+
+
+    /*** Render the Game World from a snapshot ***/
+    void Game::Render(const RenderSnapshot* snapshot) {
 
         /* Setup the view matrix and OpenGL settings appropriately */
 
@@ -1575,6 +1964,11 @@ namespace game {
         );
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // Nothing to draw until the simulation publishes its first frame
+        if (!snapshot) {
+            return;
+        }
+
         // Use member variables for aspect ratio
         float aspect_ratio = static_cast<float>(window_width_) / window_height_;
 
@@ -1592,65 +1986,226 @@ namespace game {
 
         // Move the camera
         glm::mat4 camera_translation_matrix;
-        camera_translation_matrix = glm::translate(glm::mat4(1.0f), -camera_pos);
+        camera_translation_matrix = glm::translate(glm::mat4(1.0f), -snapshot->camera_pos);
     
         // Calculate the combined transformation matrix
         glm::mat4 view_matrix = window_scale_matrix * camera_zoom_matrix * camera_translation_matrix;
 
-        // Transparent sprite helper
-        glDepthMask(GL_FALSE);
-        
-        /* Render ALL the GameObjects in storage (order: back to front) */
-        
-        // Background
-        background->Render(view_matrix, current_time_);
+        // Hand the view and time to every shader at once, per object only the transform is set
+        FrameData frame;
+        frame.view_matrix = view_matrix;
+        frame.camera_pos = glm::vec4(snapshot->camera_pos, 1.0f);
+        frame.viewport_size = glm::vec2(window_width_, window_height_);
+        frame.time = glfwGetTime();
+        frame.padding = 0.0f;
+        frame_uniforms_.Update(frame);
 
-        for (int i = 0; i < enemy_spawn_arr.size(); ++i) {
-            enemy_spawn_arr[i]->Render(view_matrix, current_time_);
-        }
+        /* Queue the snapshot, the layers keep it back to front and inside each one the
+         * queue orders draws to switch shaders, textures and blending as little as it can.
+         * It handles depth itself, opaque texels first with depth writes and then the rest */
+        render_queue_.Clear();
 
-        win_image->Render(view_matrix, current_time_);
+        // Background, the starfield is one full-screen triangle (the vertex shader makes its corners)
+        ScreenPassInstance sky = { &screen_shader_, 0, glm::vec2(0.0f), WORLD_SIZE * 0.5f };
+        render_queue_.Submit(RENDER_LAYER_SKY, BLEND_PREMULTIPLIED, &sky);
 
-        for (int i = 0; i < buyable_arr.size(); ++i) {
-            buyable_arr[i]->Render(view_matrix, current_time_);
-            buyable_arr[i]->GetIcon()->Render(view_matrix, current_time_);
+        RenderStaticLayer(snapshot, frame);
+
+        // Foreground, particles blend additively
+        for (int i = 0; i < snapshot->particles.size(); i++) {
+            render_queue_.Submit(RENDER_LAYER_WORLD, BLEND_ADDITIVE, &snapshot->particles[i]);
         }
 
-        // Foreground
-        glBlendFunc(GL_ONE, GL_ONE);
-        for (int i = 0; i < particle_system_arr.size(); i++) {
-            particle_system_arr[i]->Render(view_matrix, glfwGetTime());
+        const std::vector<SpriteInstance>& foreground_sprites = snapshot->sprites[LAYER_FOREGROUND];
+        for (int i = 0; i < foreground_sprites.size(); ++i) {
+            render_queue_.Submit(RENDER_LAYER_WORLD, BLEND_PREMULTIPLIED, &foreground_sprites[i]);
         }
-        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-        for (int i = 0; i < gunner_projectile_arr.size(); ++i) {
-            gunner_projectile_arr[i]->Render(view_matrix, current_time_);
+        // Vignette over the world, under the overlays
+        ScreenPassInstance vignette = { &screen_shader_, SCREEN_VARIANT_VIGNETTE, glm::vec2(snapshot->vignette_center), 0.0f };
+        render_queue_.Submit(RENDER_LAYER_VIGNETTE, BLEND_PREMULTIPLIED, &vignette);
+
+        // Overlays
+        for (int i = 0; i < snapshot->texts.size(); ++i) {
+            render_queue_.Submit(RENDER_LAYER_TEXT, BLEND_PREMULTIPLIED, &snapshot->texts[i]);
         }
 
-        for (int i = 0; i < projectile_arr.size(); ++i) {
-            projectile_arr[i]->Render(view_matrix, current_time_);
+        const std::vector<SpriteInstance>& hud_sprites = snapshot->sprites[LAYER_HUD];
+        for (int i = 0; i < hud_sprites.size(); ++i) {
+            render_queue_.Submit(RENDER_LAYER_HUD, BLEND_PREMULTIPLIED, &hud_sprites[i]);
         }
 
-        for (int i = 0; i < collectible_arr.size(); ++i) {
-            collectible_arr[i]->Render(view_matrix, current_time_);
+        // Draw it all
+        RenderStats stats = render_queue_.Execute();
+        profiler.RecordCount(COUNT_PROGRAM_BINDS, stats.program_binds);
+        profiler.RecordCount(COUNT_TEXTURE_BINDS, stats.texture_binds);
+        profiler.RecordCount(COUNT_BLEND_CHANGES, stats.blend_changes);
+        profiler.RecordCount(COUNT_DRAW_CALLS, stats.draw_calls);
+        profiler.RecordCount(COUNT_BATCHED_SPRITES, stats.batched_sprites);
+
+
+        // Set back to true, prevents the resize bug from occurring
+        glDepthMask(GL_TRUE);
+    }
+
+
+    /*** Queue the background sprites, or the static layer cache in their place unless it's turned off ***/
+    void Game::RenderStaticLayer(const RenderSnapshot* snapshot, FrameData& frame) {
+        const std::vector<SpriteInstance>& background_sprites = snapshot->sprites[LAYER_BACKGROUND];
+        if (!STATIC_LAYER_CACHE) {
+            for (int i = 0; i < background_sprites.size(); ++i) {
+                render_queue_.Submit(RENDER_LAYER_STATIC, BLEND_PREMULTIPLIED, &background_sprites[i]);
+            }
+            return;
         }
 
-        for (int i = 0; i < enemy_arr.size(); ++i) {
-            enemy_arr[i]->Render(view_matrix, current_time_);
+        // The view only scales and translates, so its size and center come straight out of the matrix
+        glm::vec2 view_size(2.0f / frame.view_matrix[0][0], 2.0f / frame.view_matrix[1][1]);
+        glm::vec2 view_center(snapshot->camera_pos);
+        glm::ivec2 view_pixels(window_width_, window_height_);
+        int sprite_count = background_sprites.size();
+        double time = glfwGetTime();
+
+        // Redraw the cache if it's stale, straight away and with its own view for the one draw of each sprite
+        bool refreshed = static_layer_.NeedsRefresh(view_center, view_size, view_pixels, sprite_count, time);
+        if (refreshed) {
+            glm::mat4 view_matrix = frame.view_matrix;
+            frame.view_matrix = static_layer_.BeginRefresh(view_center, view_size, view_pixels, sprite_count, time);
+            frame_uniforms_.Update(frame);
+            for (int i = 0; i < background_sprites.size(); ++i) {
+                background_sprites[i].Draw();
+            }
+            static_layer_.EndRefresh(view_pixels);
+            frame.view_matrix = view_matrix;
+            frame_uniforms_.Update(frame);
+        }
+
+        static_composite_ = { &sprite_shader_, sprite_, static_layer_.GetTexture(), static_layer_.GetTransform(), false };
+        render_queue_.Submit(RENDER_LAYER_STATIC, BLEND_PREMULTIPLIED, &static_composite_);
+
+        // What drawing the sprites directly would have cost, only counted on frames that didn't have to
+        int calls_saved = -1;
+        float fill_saved = -(float)(view_pixels.x * view_pixels.y);
+        if (!refreshed) {
+            glm::vec2 pixels_per_unit = glm::vec2(view_pixels) / view_size;
+            for (int i = 0; i < background_sprites.size(); ++i) {
+                const glm::mat4& m = background_sprites[i].transform;
+                fill_saved += std::abs(m[0][0] * m[1][1] - m[0][1] * m[1][0]) * pixels_per_unit.x * pixels_per_unit.y;
+            }
+            calls_saved += sprite_count;
         }
+        profiler.RecordCount(COUNT_STATIC_CALLS_SAVED, calls_saved);
+        profiler.RecordCount(COUNT_STATIC_FILL_SAVED, (int)fill_saved);
+    }
 
-        player->Render(view_matrix, current_time_);
 
-        // Overlays
-        vignette->Render(view_matrix, current_time_);
-      
-        title->Render(view_matrix, current_time_);
+    /*** Draw everything the game can draw into a small offscreen target, nothing of it reaches the window ***/
+    void Game::PrewarmPipeline(void) {
+        double start_time = glfwGetTime();
+
+        // Offscreen target with the same kind of attachments as the window
+        GLuint framebuffer, color, depth;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glGenTextures(1, &color);
+        glBindTexture(GL_TEXTURE_2D, color);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, PREWARM_TARGET_SIZE, PREWARM_TARGET_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+        glGenRenderbuffers(1, &depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, PREWARM_TARGET_SIZE, PREWARM_TARGET_SIZE);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) {
+            glViewport(0, 0, PREWARM_TARGET_SIZE, PREWARM_TARGET_SIZE);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glDepthMask(GL_FALSE);
+
+            FrameData frame = { glm::mat4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+                glm::vec2(PREWARM_TARGET_SIZE), (float)start_time, 0.0f };
+            frame_uniforms_.Update(frame);
+            glm::mat4 transform = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+
+            // Text uses every glyph in the font (tex_[11]), a string at a time, and the font on its own
+            std::vector<TextInstance> texts(1, { &text_shader_, sprite_, tex_[11], transform, 0 });
+            for (int c = ' '; c <= '~'; c += MAX_TEXT_LENGTH) {
+                TextInstance text = { &text_shader_, sprite_, tex_[11], transform, 0 };
+                for (int i = 0; i < MAX_TEXT_LENGTH && c + i <= '~'; ++i) {
+                    text.content[text.length++] = c + i;
+                }
+                texts.push_back(text);
+            }
 
-        hud->RenderAll(view_matrix, current_time_);
+            // Both blend states Render uses, additive for particles and pre-multiplied alpha for the rest
+            const GLenum blend_dst[] = { GL_ONE, GL_ONE_MINUS_SRC_ALPHA };
+            for (int b = 0; b < 2; ++b) {
+                glBlendFunc(GL_ONE, blend_dst[b]);
 
+                for (int t = 0; t < num_textures_; ++t) {
+                    if (!tex_loaded_[t]) {
+                        continue;
+                    }
+                    SpriteInstance sprite = { &sprite_shader_, sprite_, tex_[t], transform, false };
+                    sprite.Draw();
+                    sprite.Draw(true);
+                    sprite.ghost = true;
+                    sprite.Draw();
+                    sprite.Draw(true);
+
+                    ParticleInstance particles = { &particle_shader_, particles_, tex_[t], transform };
+                    particles.Draw();
+                    particles.shader = &player_particle_shader_;
+                    particles.geometry = player_particles_;
+                    particles.Draw();
+                }
+                for (int i = 0; i < texts.size(); ++i) {
+                    texts[i].Draw();
+                }
+                for (unsigned int key = 0; key <= SCREEN_VARIANT_VIGNETTE; ++key) {
+                    screen_shader_.SelectVariant(key);
+                    screen_shader_.Enable();
+                    glDrawArrays(GL_TRIANGLES, 0, 3);
+                }
+            }
 
-        // Set back to true, prevents the resize bug from occurring
-        glDepthMask(GL_TRUE);
+            // One frame through the render queue, so the opaque depth pass and the batched sprites' stream
+            // and vertex layout are set up too. A run of plain sprites and one of ghosts, over the sky
+            glClear(GL_DEPTH_BUFFER_BIT);
+            std::vector<SpriteInstance> batch;
+            for (int i = 0; i < PREWARM_BATCH_SPRITES * 2; ++i) {
+                SpriteInstance sprite = { &sprite_shader_, sprite_, tex_[0], transform, i >= PREWARM_BATCH_SPRITES };
+                batch.push_back(sprite);
+            }
+            ScreenPassInstance sky = { &screen_shader_, 0, glm::vec2(0.0f), WORLD_SIZE * 0.5f };
+
+            sprite_stream_.BeginFrame();
+            render_queue_.Clear();
+            render_queue_.Submit(RENDER_LAYER_SKY, BLEND_PREMULTIPLIED, &sky);
+            for (int i = 0; i < batch.size(); ++i) {
+                render_queue_.Submit(RENDER_LAYER_WORLD, BLEND_PREMULTIPLIED, &batch[i]);
+            }
+            render_queue_.Execute();
+            render_queue_.Clear();
+            sprite_stream_.EndFrame();
+
+            // Wait for the driver to actually get through it all
+            glFinish();
+            glDepthMask(GL_TRUE);
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        }
+
+        // Back to drawing into the window
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteRenderbuffers(1, &depth);
+        glDeleteTextures(1, &color);
+        glDeleteFramebuffers(1, &framebuffer);
+        int width, height;
+        glfwGetFramebufferSize(window_, &width, &height);
+        glViewport(0, 0, width, height);
+
+        if (PRINT_PROFILE) {
+            std::cout << "Pipeline warm-up: " << (glfwGetTime() - start_time) * 1000.0 << "ms" << std::endl;
+        }
     }
 
 
@@ -1674,16 +2229,40 @@ namespace game {
 
 
     /*** Load all the textures ***/
-    void Game::LoadTextures(std::vector<std::string>& textures) {
+    void Game::LoadTextures(std::vector<std::string>& textures, const std::vector<int>& atlases) {
 
         // Allocate a buffer for all texture references
-        int num_textures = textures.size();
-        tex_ = new GLuint[num_textures];
-        glGenTextures(num_textures, tex_);
-
-        // Load each texture
-        for (int i = 0; i < num_textures; i++) {
-            SetTexture(tex_[i], (resources_directory_g + textures[i]).c_str());
+        num_textures_ = textures.size();
+        tex_ = new GLuint[num_textures_];
+        glGenTextures(num_textures_, tex_);
+        tex_loaded_.assign(num_textures_, false);
+
+        // Rows of the small mip levels aren't padded to 4 bytes
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        // Load each texture, empty names keep their slot so the ones after keep their index
+        std::vector<std::pair<size_t, int> > sizes;
+        size_t total_bytes = 0;
+        for (int i = 0; i < num_textures_; i++) {
+            if (textures[i].empty()) {
+                continue;
+            }
+            bool atlas = std::find(atlases.begin(), atlases.end(), i) != atlases.end();
+            size_t bytes = SetTexture(tex_[i], (resources_directory_g + textures[i]).c_str(), !atlas);
+            tex_loaded_[i] = bytes > 0;
+            sizes.push_back(std::make_pair(bytes, i));
+            total_bytes += bytes;
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        // Report what they take up on the GPU, biggest first
+        if (PRINT_PROFILE) {
+            std::sort(sizes.begin(), sizes.end(), std::greater<std::pair<size_t, int> >());
+            std::cout << "Textures use " << total_bytes / (1024.0 * 1024.0) << "MB ("
+                << (TEXTURE_COMPRESSION ? "compressed" : "uncompressed") << ", mipmapped)" << std::endl;
+            for (int i = 0; i < sizes.size(); ++i) {
+                std::cout << "    " << textures[sizes[i].second] << ": " << sizes[i].first / 1024.0 << "KB" << std::endl;
+            }
         }
 
         // Set first texture in the array as default
@@ -1692,7 +2271,7 @@ namespace game {
 
 
     /*** Set an objects texture ***/
-    void Game::SetTexture(const GLuint& w, const char *fname) {
+    size_t Game::SetTexture(const GLuint& w, const char *fname, bool mipmaps) {
 
         // Bind texture buffer
         glBindTexture(GL_TEXTURE_2D, w);
@@ -1704,26 +2283,60 @@ namespace game {
         // Error checking
         if (!image) {
             std::cout << "Cannot load texture " << fname << std::endl;
-            return;
+            return 0;
         }
 
-        // Premultiply alpha if needed
+        // Premultiply alpha if needed, before the mip levels are made so they average correctly
         if (channels == 4) {
             PremultiplyAlpha(image, width * height);
         }
 
-        // Determine format
+        // Determine format, compressed is DXT5 to keep the alpha and DXT1 without it
         GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, image);
+        GLenum internal_format = format;
+        if (TEXTURE_COMPRESSION && mipmaps && GLEW_EXT_texture_compression_s3tc) {
+            internal_format = (channels == 4) ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        }
+
+        // Upload the image and, for mipmaps, every level below it down to 1x1
+        std::vector<unsigned char> level(image, image + width * height * channels);
         SOIL_free_image_data(image);
+        int levels = 0;
+        while (true) {
+            glTexImage2D(GL_TEXTURE_2D, levels, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, level.data());
+            levels++;
+            if (!mipmaps || (width == 1 && height == 1)) {
+                break;
+            }
+            HalveImage(level, width, height, channels);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
 
         // Texture Wrapping, Tiled
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-        // Texture Filtering
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        // Texture Filtering, blending between mip levels when shrunk
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // Add up its size, the driver knows the compressed sizes and uncompressed texels are 4 bytes (RGB is padded)
+        GLint compressed = GL_FALSE;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+        size_t bytes = 0;
+        for (int i = 0; i < levels; ++i) {
+            GLint level_width = 0, level_height = 0, level_size = 0;
+            if (compressed) {
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &level_size);
+            }
+            else {
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_WIDTH, &level_width);
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_HEIGHT, &level_height);
+                level_size = level_width * level_height * 4;
+            }
+            bytes += level_size;
+        }
+        return bytes;
     }
 
 
@@ -1737,4 +2350,36 @@ namespace game {
         }
     }
 
+
+
+    /*** Box filter down to the next mip level, an odd row or column left over is folded into the last texel ***/
+    void Game::HalveImage(std::vector<unsigned char>& image, int& width, int& height, int channels) {
+        int half_width = std::max(width / 2, 1);
+        int half_height = std::max(height / 2, 1);
+        std::vector<unsigned char> half(half_width * half_height * channels);
+
+        for (int y = 0; y < half_height; ++y) {
+            int y0 = std::min(y * 2, height - 1);
+            int y1 = (y == half_height - 1) ? height - 1 : std::min(y * 2 + 1, height - 1);
+            for (int x = 0; x < half_width; ++x) {
+                int x0 = std::min(x * 2, width - 1);
+                int x1 = (x == half_width - 1) ? width - 1 : std::min(x * 2 + 1, width - 1);
+                for (int c = 0; c < channels; ++c) {
+                    int sum = 0, count = 0;
+                    for (int sy = y0; sy <= y1; ++sy) {
+                        for (int sx = x0; sx <= x1; ++sx) {
+                            sum += image[(sy * width + sx) * channels + c];
+                            count++;
+                        }
+                    }
+                    half[(y * half_width + x) * channels + c] = (unsigned char)((sum + count / 2) / count);
+                }
+            }
+        }
+
+        image.swap(half);
+        width = half_width;
+        height = half_height;
+    }
+
 } // namespace game
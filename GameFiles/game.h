@@ -6,12 +6,18 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <algorithm>
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <glm/gtc/matrix_transform.hpp> 
 #include <SOIL/SOIL.h>
 #include <iostream>
 #include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
 #include <path_config.h>
 
 #include "audio_manager.h"
@@ -32,6 +38,17 @@
 #include "particle_system.h"
 #include "waves.h"
 #include "buyable_item.h"
+#include "job_system.h"
+#include "entity_store.h"
+#include "timer_wheel.h"
+#include "collision_grid.h"
+#include "world_chunks.h"
+#include "render_snapshot.h"
+#include "frame_uniforms.h"
+#include "static_layer.h"
+#include "stream_ring.h"
+#include "render_queue.h"
+#include "profiler.h"
 
 #include "defs.h"
 
@@ -57,16 +74,28 @@ namespace game {
         // Destroy the game world by freeing memory and shutting down the audio manager
         void DestroyGameWorld(void);
 
-        // Play an intro sequence with the title of the game appearing, allows the player to get ready
+        // Start an intro sequence with the title of the game appearing, allows the player to get ready.
+        // It plays out at the start of MainLoop()
         void PlayIntro(void);
 
-        // Run the game (keep the game active) by defining a loop which we stay until the window closes
+        /* Run the game (keep the game active) by defining a loop which we stay until the window closes.
+         * The game is simulated on its own thread while this one handles window events and drawing */
         void MainLoop(void);
 
     private:
 
             /* PRIVATE MEMBER FUNCTIONS */
 
+        // Body of the simulation thread, steps the game and publishes a snapshot of it each frame
+        void SimulationLoop(void);
+        void StopSimulation(void);
+
+        // Count down the intro, then hand over to gameplay
+        void UpdateIntro(void);
+
+        // Read the keys and mouse on the main thread, for the simulation thread to pick up
+        void PollInput(void);
+
         // Handle user input
         void HandleControls(double delta_time);
 
@@ -89,45 +118,61 @@ namespace game {
         void UpdateCollectibles(double delta_time);
         void UpdateHUD(double delta_time);
         
+        // Collision stage, contacts are found in parallel then applied one by one in a fixed order
+        void DetectCollisions(void);
+        void ResolveCollisions(void);
+
         // Enemy-Specific update helpers
-        void EnemyCollisionCheck(EnemyGameObject* enemy);
         void ExplodeEnemy(EnemyGameObject* enemy);
 
-        // Check against projectile arrays for ray-circle collision
-        void EnemyShotCheck(EnemyGameObject* enemy, double delta_time);
-        void PlayerShotCheck(double delta_time);
-
         // Collectible-Specific helpers
         void CollectPowerUp(CollectibleGameObject* collectible);
   
         // Spawning of game objects
-        void SpawnEnemy(void);
+        void SpawnEnemyBatch(void);
+        bool SpawnEnemy(const glm::vec3& spawn_pos);
         void SpawnCollectible(EnemyGameObject* enemy);
         void SpawnPlayerBullet(void);
         void SpawnGunnerBullet(GunnerEnemy* gunner);
 
-        // General Use Helper methods
-        bool CollisionCheck(GameObject* obj_1, GameObject* obj_2);
-        bool RayCircleCheck(ProjectileGameObject* bullet, GameObject* obj, float col_dist);
+        // General Use Helper methods, the checks only test and never change either object
+        bool CollisionCheck(GameObject* obj_1, GameObject* obj_2) const;
+        bool RayCircleCheck(ProjectileGameObject* bullet, GameObject* obj, float col_dist) const;
         void KillPlayer(void);
         void GameOver(void);
         void WinGame(void);
         
-        // Render the game world
-        void Render(void);
+        // Copy what's needed to draw the game world into the next snapshot (simulation thread)
+        void PublishSnapshot(void);
+
+        // View culling for PublishSnapshot, objects outside the camera's view rect are left out of the snapshot
+        glm::vec2 GetViewportSize(void) const;
+        bool IsInView(const glm::vec3& position, float radius) const;
+        void AddIfVisible(RenderSnapshot& snapshot, const GameObject* obj, SnapshotLayer layer, float margin = 0.0f);
+
+        // Render the game world from a snapshot (main thread), everything goes through the render queue
+        void Render(const RenderSnapshot* snapshot);
+        void RenderStaticLayer(const RenderSnapshot* snapshot, FrameData& frame);
+
+        // Draw every shader, texture and blend state combination once offscreen, so the driver
+        // finishes setting them up during the intro instead of the first time they show up in a fight
+        void PrewarmPipeline(void);
 
         // Callback for when the window is resized
         static void ResizeCallback(GLFWwindow* window, int width, int height);
 
-        // Load all textures in the game
-        void LoadTextures(std::vector<std::string>& textures);
+        // Load all textures in the game, atlases (looked up by hand in a shader) get no mip levels or compression
+        void LoadTextures(std::vector<std::string>& textures, const std::vector<int>& atlases);
 
-        // Set a specific texture
-        void SetTexture(const GLuint& w, const char* fname);
+        // Set a specific texture, returns the bytes it takes up on the GPU (0 if it couldn't be loaded)
+        size_t SetTexture(const GLuint& w, const char* fname, bool mipmaps);
 
         // Pre-multiply alpha channels, needed for rendering transparent parts in textures
         void PremultiplyAlpha(unsigned char* image, int pixelCount);
 
+        // Shrink an image to the next mip level, half the size with each texel averaging 2x2 of the old ones
+        void HalveImage(std::vector<unsigned char>& image, int& width, int& height, int channels);
+
 
             /* PRIVATE MEMBER VARIABLES */
 
@@ -140,7 +185,6 @@ namespace game {
 
         // All geometry types (dash)
         Geometry* sprite_;
-        Geometry* tiling_sprite_;
         Geometry* particles_;
         Geometry* player_particles_;
 
@@ -154,15 +198,38 @@ namespace game {
         Shader particle_shader_;
         Shader player_particle_shader_;
 
+        // Shader for full-screen passes, the starfield background and the vignette
+        Shader screen_shader_;
+
+        // View and time shared by every shader, written once per frame
+        FrameUniforms frame_uniforms_;
+
+        // Background sprites as of their last refresh, composited instead of drawn one by one
+        StaticLayer static_layer_;
+        SpriteInstance static_composite_;
+
+        // Vertices written by the CPU each frame, the render queue's sprite batches
+        StreamRing sprite_stream_;
+
+        // Draws of the frame being rendered, sorted to keep state changes down
+        RenderQueue render_queue_;
+
         // References to textures, this needs to be a pointer
         GLuint* tex_;
+        int num_textures_;
+
+        // Which slots LoadTextures actually uploaded, the rest are generated names with nothing in them
+        std::vector<bool> tex_loaded_;
 
-        // Keep track of time
-        double current_time_;
+        // Components of every GameObject, the objects themselves are views of it
+        EntityStore entities;
+
+        // Timers for game objects, one on game time and one on enemy time (slowed by cold shock)
+        TimerWheel timers;
+        TimerWheel enemy_timers;
 
         // Game Object Storage, now seperated to optimize the Update() function
-        GameObject* vignette;
-        GameObject* background;
+        WorldChunks* world;
         GameObject* win_image;
 
         HUD* hud;
@@ -170,7 +237,6 @@ namespace game {
 
         PlayerGameObject* player;
         std::vector<EnemyGameObject*> enemy_arr;
-        std::vector<EnemySpawn*> enemy_spawn_arr;
         std::vector<ProjectileGameObject*> projectile_arr;
         std::vector<ProjectileGameObject*> gunner_projectile_arr;
         std::vector<CollectibleGameObject*> collectible_arr;
@@ -187,12 +253,40 @@ namespace game {
         Weapon* rifle;
         Weapon* sniper;
 
+        // Simulation thread, and the first error it ran into to be rethrown on the main thread
+        std::thread simulation_thread;
+        std::atomic<bool> simulation_running;
+        std::exception_ptr simulation_error;
+
+        // Finished frames going from the simulation thread to the main thread
+        SnapshotBuffer snapshots;
+
+        // Frame timings from both threads
+        Profiler profiler;
+
+        // Input state, polled on the main thread then copied into input at the start of each step
+        struct InputState {
+            bool up, down, left, right;     // W, S, A, D
+            bool shoot;                     // left-click
+            bool interact;                  // F
+            bool quit;                      // ESC
+            bool debug_kill;                // K
+            double cursor_x, cursor_y;
+            int window_width, window_height;
+            double poll_time;
+        };
+        InputState input;
+        InputState latest_input;
+        std::mutex input_mutex;
+
         // Timers
         Timer intro_timer;
         Timer enemy_spawn_timer;
         Timer firing_cooldown;
         Timer close_window_timer;
         Timer update_fps_timer;
+        Timer wave_reload_timer;
+        Timer profile_timer;
 
         // Audio Variables, should be callable 
         audio_manager::AudioManager am;
@@ -206,18 +300,52 @@ namespace game {
         glm::vec3 title_offset;
         glm::vec3 win_image_offset;
 
+        // View rect of the snapshot being built, and how many objects made it in or were culled
+        glm::vec2 view_min;
+        glm::vec2 view_max;
+        int drawn_count;
+        int culled_count;
+
         // Flags
+        bool playing_intro;
         bool update_flag;
         bool holding_shoot;
         bool holding_interact;
         bool game_won;
+        bool pipeline_warm;
 
         // Trackers
+        double intro_start_time;
         glm::vec3 cursor_pos;
         int interact_id;
 
-        // Random Number Generation Helper
+        // Worker threads for per-object updates
+        JobSystem jobs;
+
+        // Side effects found by enemies updating in parallel, one buffer per thread, applied serially after
+        enum EnemyEventType { GUNNER_SHOOT, KAMIKAZE_BURN };
+        struct EnemyEvent {
+            EnemyEventType type;
+            int enemy_index;
+        };
+        std::vector<std::vector<EnemyEvent> > enemy_events;
+
+        // Collision broad-phase over the live enemies, and the contacts each thread found
+        enum ContactType { CONTACT_GUNNER_BULLET, CONTACT_PLAYER_BULLET, CONTACT_CHASER_ARM, CONTACT_ENEMY_BODY, CONTACT_COLLECTIBLE };
+        struct Contact {
+            ContactType type;
+            int first;  // bullet, enemy or collectible index
+            int second; // enemy index for player bullets, otherwise 0
+        };
+        CollisionGrid enemy_grid;
+        std::vector<std::vector<Contact> > contacts;
+
+        // Random Number Generation Helpers, the generator is seeded once since seeding is slow
         std::random_device rd;
+        std::mt19937 rng;
+
+        // Portal the next spawned enemy comes out of, batches go round all of them
+        int next_spawn_portal;
 
     }; // class Game
 
@@ -6,16 +6,22 @@
 
 namespace game {
 
-    /*** Constructor, initalizes values to params and default values ***/
+    // Shared by all GameObjects, set by the Game on Init
+    EntityStore* GameObject::store_ = NULL;
+    TimerWheel* GameObject::timers_ = NULL;
+
+
+    /*** Constructor, creates the object's entity, the store fills in default values ***/
     GameObject::GameObject(const glm::vec3 &position, Geometry* geom, Shader* shader, const GLuint& texture)
-        : position_(position), geometry_(geom), shader_(shader), texture_(texture) {
-        // default initializations
-        scale_ = glm::vec2(1.0f);
-        angle_ = 0.0f;
-        velocity_ = glm::vec3(0.0f);
-        acceleration_ = glm::vec3(0.0f);
-        ghost_ = false;
-        hidden_ = false;
+        : erase_timer_(0) {
+        entity_ = store_->Create(position, geom, shader, texture);
+    }
+
+
+    /*** Destructor, frees the object's slot in the store and drops its erase timer ***/
+    GameObject::~GameObject() {
+        timers_->Cancel(erase_timer_);
+        store_->Destroy(entity_);
     }
 
 
@@ -23,47 +29,36 @@ namespace game {
     void GameObject::Update(double delta_time) {}
 
 
-    /*** Universal render function for all game objects ***/
-    void GameObject::Render(const glm::mat4& view_matrix, double current_time) {
-
-        // Set up the shader
-        shader_->Enable();
+    /*** Universal snapshot function for all game objects, copies out a single sprite ***/
+    void GameObject::AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const {
+        int slot = Slot();
+        snapshot.sprites[layer].push_back({ store_->shader[slot], store_->geometry[slot], store_->texture[slot], GetTransform(), store_->ghost[slot] != 0 });
+    }
 
-        // Set up the view matrix
-        shader_->SetUniformMat4("view_matrix", view_matrix);
 
-        // Handle ghost mode
-        shader_->SetUniform1i("ghost", ghost_);
+    /*** Get the object's transformation matrix, scale then rotate then translate ***/
+    glm::mat4 GameObject::GetTransform(void) const {
+        int slot = Slot();
+        const glm::vec2& scale = store_->scale[slot];
 
         // Setup the scaling matrix for the shader
-        glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_.x, scale_.y, 1.0));
+        glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale.x, scale.y, 1.0));
 
         // Setup the rotation matrix for the shader
-        glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.0, 0.0, 1.0));
+        glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), store_->angle[slot], glm::vec3(0.0, 0.0, 1.0));
 
         // Set up the translation matrix for the shader
-        glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
-
-        // Setup the transformation matrix for the shader
-        glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
-
-        // Set the transformation matrix in the shader
-        shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-
-        // Set up the geometry
-        geometry_->SetGeometry(shader_->GetShaderProgram());
-
-        // Bind the entity's texture
-        glBindTexture(GL_TEXTURE_2D, texture_);
+        glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), store_->position[slot]);
 
-        // Draw the entity
-        glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        // Combine them
+        return translation_matrix * rotation_matrix * scaling_matrix;
     }
 
 
     /*** Get the direction an object is facing towards ***/
     glm::vec3 GameObject::GetBearing(void) const {
-        glm::vec3 dir(cos(angle_) - HALF_PI, sin(angle_) - HALF_PI, 0.0);
+        float angle = GetRotation();
+        glm::vec3 dir(cos(angle) - HALF_PI, sin(angle) - HALF_PI, 0.0);
         return dir;
     }
 
@@ -71,7 +66,8 @@ namespace game {
     /*** Get the right side of an object ***/
     glm::vec3 GameObject::GetRight(void) const {
         float pi_over_two = HALF_PI;
-        glm::vec3 dir(cos(angle_ - pi_over_two), sin(angle_ - pi_over_two), 0.0);
+        float angle = GetRotation();
+        glm::vec3 dir(cos(angle - pi_over_two), sin(angle - pi_over_two), 0.0);
         return dir;
     }
 
@@ -83,7 +79,7 @@ namespace game {
         if (angle < 0.0){
             angle += TWO_PI;
         }
-        angle_ = angle;
+        Angle() = angle;
     }
 
     
@@ -109,22 +105,48 @@ namespace game {
     }
 
 
-    /*** Base Erase Timer initalizer, defaults to 5 seconds ***/
+    /*** Base Erase Timer initalizer, defaults to DEFAULT_ERASE_TIMER seconds ***/
     void GameObject::StartEraseTimer() {
-        erase_timer_.Start(DEFAULT_ERASE_TIMER);
+        SetEraseTime(DEFAULT_ERASE_TIMER);
     }
 
 
-    /*** Checks if the erase timer has finished ***/
-    bool GameObject::EraseTimerCheck() {
-        return erase_timer_.Finished();
+    /*** Start the erase timer on the wheel, restarting it if it was already running ***/
+    void GameObject::SetEraseTime(float duration) {
+        timers_->Cancel(erase_timer_);
+        erase_timer_ = timers_->Schedule(duration, this, TIMER_ERASE);
+        store_->expired[Slot()] = false;
     }
 
 
-    /*** Hides an Object by setting scale to 0, detectable via hidden_ flag ***/
+    /*** Checks if the erase timer has fired ***/
+    bool GameObject::EraseTimerCheck() const {
+        return store_->expired[Slot()] != 0;
+    }
+
+
+    /*** The erase timer fired, flag the object for removal ***/
+    void GameObject::OnTimer(int timer_id) {
+        if (timer_id == TIMER_ERASE) {
+            erase_timer_ = 0;
+            store_->expired[Slot()] = true;
+        }
+    }
+
+
+    /*** Hides an Object by setting scale to 0, detectable via the hidden flag ***/
     void GameObject::Hide(void) {
-        scale_ = glm::vec2(0.0f);
-        hidden_ = true;
+        int slot = Slot();
+        store_->scale[slot] = glm::vec2(0.0f);
+        store_->hidden[slot] = true;
+    }
+
+
+    /*** Undoes Hide, the scale it was shown at before hiding isn't kept so the caller gives it ***/
+    void GameObject::Show(const glm::vec2& scale) {
+        int slot = Slot();
+        store_->scale[slot] = scale;
+        store_->hidden[slot] = false;
     }
 
 } // namespace game
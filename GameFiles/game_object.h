@@ -1,5 +1,6 @@
 // GameObject base class declarations
-// responsible for handling the rendering and updating of an object in the game world
+// responsible for handling the rendering and updating of an object in the game world,
+// its components live in the EntityStore and the object is a view of them
 
 #ifndef GAME_OBJECT_H_
 #define GAME_OBJECT_H_
@@ -13,44 +14,74 @@
 #include "shader.h"
 #include "geometry.h"
 #include "timer.h"
+#include "render_snapshot.h"
+#include "entity_store.h"
+#include "timer_wheel.h"
 #include "defs.h"
 
 namespace game {
 
-    class GameObject {
+    // Ids of the timers GameObjects schedule on a TimerWheel
+    enum ObjectTimer {
+        TIMER_ERASE,
+        TIMER_REGEN,
+        TIMER_DOUBLE_POINTS,
+        TIMER_BULLET_BOOST,
+        TIMER_COLD_SHOCK,
+        TIMER_GUNNER_SHOOT
+    };
+
+
+    class GameObject : public TimerListener {
 
         public:
             // Constructor
             GameObject(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture);
 
-            // Deconstructor + Polymorphism Helper
-            virtual ~GameObject() = default;
+            // Deconstructor + Polymorphism Helper, removes the object's components from the store
+            virtual ~GameObject();
+
+            // Objects own their entity, so they can't be copied
+            GameObject(const GameObject&) = delete;
+            GameObject& operator=(const GameObject&) = delete;
+
+            // Store every GameObject's components go in, set once before any are created
+            static void SetEntityStore(EntityStore* store) { store_ = store; }
+
+            // Wheel that game-time timers (erasing, power-ups, regen) go on, set once before any are created
+            static void SetTimerWheel(TimerWheel* timers) { timers_ = timers; }
 
             // Update the GameObject's state. Can be overriden in children
             virtual void Update(double delta_time);
 
-            // Renders the GameObject 
-            virtual void Render(const glm::mat4& view_matrix, double current_time);
+            // Adds what's needed to draw the GameObject to a snapshot, drawing happens on the render thread
+            virtual void AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const;
 
             // Getters
-            inline const glm::vec3& GetPosition(void) const { return position_; }
-            inline const glm::vec2& GetScale(void) const { return scale_; }
-            inline float GetXRadius(void) const { return scale_.x / 2; }
-            inline float GetYRadius(void) const { return scale_.y / 2; }
-            inline const glm::vec3& GetVelocity(void) const { return velocity_; }
-            inline const glm::vec3& GetAcceleration(void) const { return acceleration_; }
-            inline bool IsGhost() const { return ghost_; }
-            inline float GetRotation(void) const { return angle_; }
+            inline const glm::vec3& GetPosition(void) const { return store_->position[Slot()]; }
+            inline const glm::vec2& GetScale(void) const { return store_->scale[Slot()]; }
+            inline float GetXRadius(void) const { return GetScale().x / 2; }
+            inline float GetYRadius(void) const { return GetScale().y / 2; }
+            inline float GetBoundingRadius(void) const { return glm::length(GetScale()) / 2; } // covers any rotation
+            inline const glm::vec3& GetVelocity(void) const { return store_->velocity[Slot()]; }
+            inline const glm::vec3& GetAcceleration(void) const { return store_->acceleration[Slot()]; }
+            inline bool IsGhost() const { return store_->ghost[Slot()] != 0; }
+            inline float GetRotation(void) const { return store_->angle[Slot()]; }
+            inline Shader* GetShader(void) const { return store_->shader[Slot()]; }
+            inline Geometry* GetGeometry(void) const { return store_->geometry[Slot()]; }
+            inline GLuint GetTexture(void) const { return store_->texture[Slot()]; }
+            inline Entity GetEntity(void) const { return entity_; }
             glm::vec3 GetBearing(void) const;
             glm::vec3 GetRight(void) const;
+            glm::mat4 GetTransform(void) const;
 
             // Setters
-            inline void SetPosition(const glm::vec3& position) { position_ = position; }
-            inline void SetScale(const glm::vec2& scale) { scale_ = scale; }
-            inline void SetTexture(const GLuint& texture) { texture_ = texture; }
-            inline void SetVelocity(const glm::vec3& velocity) { velocity_ = velocity; }
-            inline void SetAcceleration(const glm::vec3& acceleration) { acceleration_ = acceleration; }
-            inline void SetGhost(bool ghost) { ghost_ = ghost; }
+            inline void SetPosition(const glm::vec3& position) { Position() = position; }
+            inline void SetScale(const glm::vec2& scale) { Scale() = scale; }
+            inline void SetTexture(const GLuint& texture) { store_->texture[Slot()] = texture; }
+            inline void SetVelocity(const glm::vec3& velocity) { Velocity() = velocity; }
+            inline void SetAcceleration(const glm::vec3& acceleration) { Acceleration() = acceleration; }
+            inline void SetGhost(bool ghost) { Ghost() = ghost; }
             void SetRotation(float angle);
 
             // Linear Interpolation helper
@@ -58,34 +89,40 @@ namespace game {
 
             // Timer handling
             virtual void StartEraseTimer(void); 
-            virtual bool EraseTimerCheck(void);
+            bool EraseTimerCheck(void) const;
+
+            // Called by the timer wheel when one of the object's timers fires, children handle their own ids
+            void OnTimer(int timer_id) override;
 
             // Object Hiding (scale=0 and a flag) Handling
             void Hide(void);
-            inline bool IsHidden(void) const { return hidden_; }
+            void Show(const glm::vec2& scale);
+            inline bool IsHidden(void) const { return store_->hidden[Slot()] != 0; }
             
 
         protected:
-            // Object's Transform Variables
-            glm::vec3 position_;
-            glm::vec2 scale_;
-            float angle_;
-            glm::vec3 velocity_;
-            glm::vec3 acceleration_;
-            bool ghost_;
-            bool hidden_;
-
-            // Geometry
-            Geometry *geometry_;
- 
-            // Shader
-            Shader *shader_;
-
-            // Object's texture reference
-            GLuint texture_;
-
-            // object timer for explosion
-            Timer erase_timer_;
+            // Start the erase timer with a specific duration
+            void SetEraseTime(float duration);
+
+            // Object's components, as references into the store. Only valid until an object is created or destroyed
+            inline int Slot(void) const { return store_->GetSlot(entity_); }
+            inline glm::vec3& Position(void) { return store_->position[Slot()]; }
+            inline glm::vec2& Scale(void) { return store_->scale[Slot()]; }
+            inline float& Angle(void) { return store_->angle[Slot()]; }
+            inline glm::vec3& Velocity(void) { return store_->velocity[Slot()]; }
+            inline glm::vec3& Acceleration(void) { return store_->acceleration[Slot()]; }
+            inline float& MoveSpeed(void) { return store_->move_speed[Slot()]; }
+            inline int& Health(void) { return store_->health[Slot()]; }
+            inline int GetStoredHealth(void) const { return store_->health[Slot()]; }
+            inline unsigned char& Ghost(void) { return store_->ghost[Slot()]; }
+
+            // The object's entity in the store
+            Entity entity_;
+            static EntityStore* store_;
+
+            // Pending erase timer, and the wheel it's on
+            TimerHandle erase_timer_;
+            static TimerWheel* timers_;
             
     }; // class GameObject
 
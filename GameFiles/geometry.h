@@ -20,7 +20,7 @@ namespace game {
             virtual void CreateGeometry(void) {};
 
             // Create the geometry (called once)
-            virtual void CreateTilingGeometry(void) {};
+            virtual void CreateTilingGeometry(float repeat) {};
 
             // Use the geometry
             virtual void SetGeometry(GLuint shader_program) {};
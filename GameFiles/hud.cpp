@@ -85,24 +85,25 @@ namespace game {
     }
 
 
-    /*** Call the Render function for all the HUD elements ***/
-    void HUD::RenderAll(const glm::mat4& view_matrix, double current_time) {
+    /*** Call the snapshot function for all the HUD elements ***/
+    void HUD::AddToSnapshot(RenderSnapshot& snapshot) const {
 
         // Skip if the hide flag is true
         if (hide) return;
 
-        // Render the Text
+        // Add the Text
         for (int i = 0; i < text_areas.size(); ++i) {
-            text_areas[i]->Render(view_matrix, current_time);
+            text_areas[i]->AddToSnapshot(snapshot, LAYER_HUD);
         }
 
-        // Render the Icons
+        // Add the Icons, each active one shifted left of the last
+        std::vector<SpriteInstance>& hud_sprites = snapshot.sprites[LAYER_HUD];
         int icons_rendered = 0;
         for (int i = 0; i < icon_areas.size(); ++i) {
             if (icon_areas[i]->is_active) {
-                GameObject* icon_obj = icon_areas[i]->icon;
-                icon_obj->SetPosition(icon_obj->GetPosition() + ((float)icons_rendered * -icon_offset));
-                icon_obj->Render(view_matrix, current_time);
+                icon_areas[i]->icon->AddToSnapshot(snapshot, LAYER_HUD);
+                glm::vec3 shift = (float)icons_rendered * -icon_offset;
+                hud_sprites.back().transform = glm::translate(glm::mat4(1.0f), shift) * hud_sprites.back().transform;
                 icons_rendered++;
             }
         }
@@ -35,8 +35,8 @@ namespace game {
         HUD(Geometry* geom, Shader* text_shader, Shader* sprite_shader, GLuint font, GLuint ico1, GLuint ico2, GLuint ico3);
         ~HUD();
 
-        // Render everything in the text_areas vector
-        void RenderAll(const glm::mat4& view_matrix, double current_time);
+        // Add all the text and active icons to a snapshot
+        void AddToSnapshot(RenderSnapshot& snapshot) const;
 
         // Text alignment helpers, also clamps text to a certain length
         std::string LeftAlignString(const std::string& input, int len);
@@ -0,0 +1,159 @@
+// JobSystem class definitions
+
+#include <algorithm>
+
+#include "job_system.h"
+
+namespace game {
+
+    /*** Constructor, no threads until Init ***/
+    JobSystem::JobSystem(void) : pending_jobs_(0), running_(false) {}
+
+
+    /*** Destructor ***/
+    JobSystem::~JobSystem() {
+        ShutDown();
+    }
+
+
+    /*** Create a queue per thread and start the workers ***/
+    void JobSystem::Init(int worker_count) {
+        if (running_) {
+            return;
+        }
+
+        if (worker_count <= 0) {
+            // hardware_concurrency may report 0 if it can't tell
+            worker_count = std::max(1, (int)std::thread::hardware_concurrency()) - 1;
+        }
+
+        // queue 0 belongs to the thread calling ParallelFor
+        for (int i = 0; i < worker_count + 1; i++) {
+            queues_.push_back(new JobQueue());
+        }
+
+        running_ = true;
+        for (int i = 0; i < worker_count; i++) {
+            workers_.push_back(std::thread(&JobSystem::WorkerLoop, this, i + 1));
+        }
+    }
+
+
+    /*** Wake every worker so it sees running_ is off, then wait for them ***/
+    void JobSystem::ShutDown(void) {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            running_ = false;
+        }
+        wake_.notify_all();
+
+        for (int i = 0; i < workers_.size(); i++) {
+            workers_[i].join();
+        }
+        workers_.clear();
+
+        for (int i = 0; i < queues_.size(); i++) {
+            delete queues_[i];
+        }
+        queues_.clear();
+    }
+
+
+    /*** Split a loop into jobs, deal them out and help until they're all done ***/
+    void JobSystem::ParallelFor(int count, int chunk_size, const RangeFunction& body) {
+        if (count <= 0) {
+            return;
+        }
+        chunk_size = std::max(1, chunk_size);
+
+        // not worth waking anyone for a single chunk, or no workers to wake
+        if (count <= chunk_size || workers_.empty()) {
+            body(0, count, 0);
+            return;
+        }
+
+        int job_count = (count + chunk_size - 1) / chunk_size;
+        std::atomic<int> remaining(job_count);
+
+        // deal the chunks round-robin so every queue starts with a fair share
+        for (int i = 0; i < job_count; i++) {
+            Job job;
+            job.body = &body;
+            job.begin = i * chunk_size;
+            job.end = std::min(count, job.begin + chunk_size);
+            job.remaining = &remaining;
+
+            JobQueue* queue = queues_[i % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->jobs.push_back(job);
+        }
+        // a worker still looking for work may take a job before this, dipping the count below 0 for a moment
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            pending_jobs_ += job_count;
+        }
+        wake_.notify_all();
+
+        // the calling thread pitches in instead of blocking
+        Job job;
+        while (remaining > 0) {
+            if (TakeJob(0, job)) {
+                (*job.body)(job.begin, job.end, 0);
+                (*job.remaining)--;
+            }
+            else {
+                // the last chunks are running elsewhere, they're short so just spin
+                std::this_thread::yield();
+            }
+        }
+    }
+
+
+    /*** Pop from the front of our own queue, otherwise steal from the back of another. A taken job no longer
+     * counts as pending, so workers go back to sleep instead of spinning while the last ones run ***/
+    bool JobSystem::TakeJob(int thread_index, Job& job) {
+        {
+            JobQueue* own = queues_[thread_index];
+            std::lock_guard<std::mutex> lock(own->mutex);
+            if (!own->jobs.empty()) {
+                job = own->jobs.front();
+                own->jobs.pop_front();
+                pending_jobs_--;
+                return true;
+            }
+        }
+
+        for (int i = 1; i < queues_.size(); i++) {
+            JobQueue* victim = queues_[(thread_index + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim->mutex);
+            if (!victim->jobs.empty()) {
+                job = victim->jobs.back();
+                victim->jobs.pop_back();
+                pending_jobs_--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    /*** Worker thread, runs jobs while there are any and sleeps otherwise ***/
+    void JobSystem::WorkerLoop(int thread_index) {
+        Job job;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait(lock, [this](void) { return !running_ || pending_jobs_ > 0; });
+                if (!running_) {
+                    return;
+                }
+            }
+
+            while (TakeJob(thread_index, job)) {
+                (*job.body)(job.begin, job.end, thread_index);
+                (*job.remaining)--;
+            }
+        }
+    }
+
+} // namespace game
@@ -0,0 +1,75 @@
+// JobSystem class declarations, a small work-stealing thread pool used to spread
+// independent per-object work (e.g. enemy updates) over every core
+
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+    // Body of a parallel loop, called with a [begin, end) range and the index of the thread running it
+    typedef std::function<void(int begin, int end, int thread_index)> RangeFunction;
+
+    class JobSystem {
+
+        public:
+            // Constructor and destructor
+            JobSystem(void);
+            ~JobSystem();
+
+            // Start the worker threads, 0 = one per core, minus the calling thread
+            void Init(int worker_count = 0);
+
+            // Stop and join the worker threads
+            void ShutDown(void);
+
+            /* Run body over [0, count) split into chunks of chunk_size, returns once
+             * every chunk is done. The calling thread works through chunks too, it
+             * always gets thread index 0 and workers get 1..GetThreadCount()-1 */
+            void ParallelFor(int count, int chunk_size, const RangeFunction& body);
+
+            // Workers plus the calling thread, use it to size per-thread buffers
+            inline int GetThreadCount(void) const { return workers_.size() + 1; }
+
+        private:
+            // One chunk of a ParallelFor
+            struct Job {
+                const RangeFunction* body;
+                int begin;
+                int end;
+                std::atomic<int>* remaining;
+            };
+
+            // Each thread owns a queue, it takes from the front and others steal from the back
+            struct JobQueue {
+                std::deque<Job> jobs;
+                std::mutex mutex;
+            };
+
+            // Grab a job, own queue first then steal, returns false if every queue is empty
+            bool TakeJob(int thread_index, Job& job);
+
+            // Body of each worker thread
+            void WorkerLoop(int thread_index);
+
+            std::vector<std::thread> workers_;
+            std::vector<JobQueue*> queues_;
+
+            // Idle workers sleep here until a ParallelFor hands out work
+            std::mutex wake_mutex_;
+            std::condition_variable wake_;
+            std::atomic<int> pending_jobs_;     // queued and not yet taken, running jobs don't count
+            std::atomic<bool> running_;
+
+    }; // class JobSystem
+
+} // namespace game
+
+#endif // JOB_SYSTEM_H_
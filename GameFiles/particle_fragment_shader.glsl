@@ -1,18 +1,19 @@
-// Source code of fragment shader
+// Source code of fragment shader for particle system, AURA makes the white player aura, TRAIL the other emitters
 #version 130
 
-// Attributes passed from the vertex shader
-in vec4 color_interp;
-in vec2 uv_interp;
+#include "fragment_inputs.glsl"
 
-// Texture sampler
-uniform sampler2D onetex;
+#ifdef AURA
+const vec3 tint = vec3(0.9, 0.9, 0.9);
+#else
+const vec3 tint = vec3(0.8, 0.6, 0.1);
+#endif
 
 void main()
 {
     // Sample texture
     vec4 color = texture2D(onetex, uv_interp);
-    color.rgb = vec3(0.8, 0.6, 0.1) * color_interp.r;
+    color.rgb = tint * color_interp.r;
 
     // Assign color to fragment
     gl_FragColor = vec4(color.r, color.g, color.b, color.a);
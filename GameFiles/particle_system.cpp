@@ -12,7 +12,7 @@ namespace game {
     ParticleSystem::ParticleSystem(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture, GameObject* parent)
 	    : GameObject(position, geom, shader, texture) {
         parent_ = parent;
-        scale_ = glm::vec2(0.08f);
+        Scale() = glm::vec2(0.08f);
     }
 
 
@@ -26,23 +26,8 @@ namespace game {
     }
 
 
-    /*** Overriden Render function, renders based on parent attributes ***/
-    void ParticleSystem::Render(const glm::mat4& view_matrix, double current_time) {
-
-        // Set up the shader
-        shader_->Enable();
-
-        // Set up the view matrix
-        shader_->SetUniformMat4("view_matrix", view_matrix);
-
-        // Setup the scaling matrix for the shader
-        glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_.x, scale_.y, 1.0));
-
-        // Setup the rotation matrix for the shader
-        glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.0, 0.0, 1.0));
-
-        // Set up the translation matrix for the shader
-        glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
+    /*** Overriden snapshot function, places the emitter based on parent attributes ***/
+    void ParticleSystem::AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const {
 
         // Set up the parent transformation matrix
         glm::mat4 parent_transformation_matrix(1.0f);
@@ -60,22 +45,9 @@ namespace game {
         }
 
         // Setup the transformation matrix for the shader
-        glm::mat4 transformation_matrix = parent_transformation_matrix * translation_matrix * rotation_matrix * scaling_matrix;
-
-        // Set the transformation matrix in the shader
-        shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-
-        // Set the time in the shader
-        shader_->SetUniform1f("time", current_time);
-
-        // Set up the geometry
-        geometry_->SetGeometry(shader_->GetShaderProgram());
-
-        // Bind the particle texture
-        glBindTexture(GL_TEXTURE_2D, texture_);
+        glm::mat4 transformation_matrix = parent_transformation_matrix * GetTransform();
 
-        // Draw the entity
-        glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        snapshot.particles.push_back({ GetShader(), GetGeometry(), GetTexture(), transformation_matrix });
     }
 
 } // namespace game
@@ -13,10 +13,15 @@ namespace game {
         public:
             ParticleSystem(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture, GameObject* parent);
 
-            void Render(const glm::mat4& view_matrix, double current_time) override;
+            // Particles go in the snapshot's particle list whatever the layer
+            void AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const override;
 
             void Update(double delta_time) override;
 
+            // The object the particles follow, without one (or while it's hidden) they're drawn off-screen
+            inline GameObject* GetParent(void) const { return parent_; }
+            inline bool HasVisibleParent(void) const { return parent_ && !parent_->IsHidden(); }
+
         private:
             GameObject *parent_;
 
@@ -1,6 +1,9 @@
-// Source code of vertex shader for particle system
+// Source code of vertex shader for particle system, AURA makes the faster player aura, TRAIL the other emitters
 #version 130
 
+// Per-frame block with the view and timer, first since it enables an extension
+#include "frame_uniforms.glsl"
+
 // Vertex buffer
 in vec2 vertex; // Vertex coordinates
 in vec2 dir;    // Velocity
@@ -9,8 +12,7 @@ in vec2 uv;     // Texture coordinates
 
 // Uniform (global) buffer
 uniform mat4 transformation_matrix;
-uniform mat4 view_matrix;
-uniform float time; // Timer
+uniform float depth;
 
 // Attributes forwarded to the fragment shader
 out vec4 color_interp;
@@ -20,7 +22,11 @@ void main() {
 
     vec4 pos;               // Vertex position
     float cycle = 2.0;      // Duration of cycle in seconds
-    float speed = 4.0;      // Speed adjustment constant
+#ifdef AURA
+    float speed = 6.0;      // Speed adjustment constant
+#else
+    float speed = 4.0;
+#endif
     float gravity = 2.8;    // Gravity in this world
     float acttime;          // Cyclic time
 
@@ -41,6 +47,7 @@ void main() {
 
     // Transform vertex position
     gl_Position = view_matrix*transformation_matrix*pos;
+    gl_Position.z = depth;
     
     // Set color
     // color_interp = vec4(0.5+0.5*cos(4*acttime),0.5*sin(4*acttime)+0.5,0.5, 1.0);
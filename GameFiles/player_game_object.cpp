@@ -9,12 +9,12 @@ namespace game {
 		: GameObject(position, geom, shader, texture) {
 
 		// initialize default values
-		health = PLAYER_INIT_HP;
-		max_health = health;
+		Health() = PLAYER_INIT_HP;
+		max_health = Health();
 		regen_cd_time = INIT_REGEN_CD;
 		regen_step_amount = INIT_REGEN_AMOUNT;
 
-		angle_ = 0;
+		Angle() = 0;
 		target_angle = 0;
 		points = 0;
 		weapon = (0, 0, 0, 0, 0, 0);
@@ -35,10 +35,21 @@ namespace game {
 		nitro_infuse = false;
 		celestial_augment = false;
 		
-		// initialize health timers
+		// initialize health timers, the rest are only scheduled once needed
 		i_frames_timer.Start(0.0);
-		regen_cd.Start(0.0);
-		regen_step.Start(0.0);
+		regen_timer = 0;
+		dp_timer = 0;
+		bb_timer = 0;
+		cs_timer = 0;
+	}
+
+
+	/*** Destructor, none of the player's timers can fire once it's gone ***/
+	PlayerGameObject::~PlayerGameObject() {
+		timers_->Cancel(regen_timer);
+		timers_->Cancel(dp_timer);
+		timers_->Cancel(bb_timer);
+		timers_->Cancel(cs_timer);
 	}
 
 
@@ -57,55 +68,86 @@ namespace game {
 		}
 
 		// Update velocity based on acceleration
-		velocity_ += acceleration_ * dt;
+		glm::vec3& position = Position();
+		glm::vec3& velocity = Velocity();
+		velocity += Acceleration() * dt;
 
 		// Ensure velocity doesn't exceed max speed
-		if (glm::length(velocity_) > max_speed) {
-			velocity_ = glm::normalize(velocity_) * max_speed;
+		if (glm::length(velocity) > max_speed) {
+			velocity = glm::normalize(velocity) * max_speed;
 		}
 
 		// Update position based on velocity, then decelerate
-		position_ += velocity_ * dt;
-		velocity_ /= 1.001 + (dt * 3); // weird
+		position += velocity * dt;
+		velocity /= 1.001 + (dt * 3); // weird
 
 		// Clamp player position to ensure no OOB movement is possible
-		position_.x = glm::clamp(position_.x, -PLAYER_X_BOUND, PLAYER_X_BOUND);
-		position_.y = glm::clamp(position_.y, -PLAYER_Y_BOUND, PLAYER_Y_BOUND);
+		position.x = glm::clamp(position.x, -PLAYER_X_BOUND, PLAYER_X_BOUND);
+		position.y = glm::clamp(position.y, -PLAYER_Y_BOUND, PLAYER_Y_BOUND);
 
 		// Update rotation using lerp with the target angle, ensures smooth motion
-		angle_ = LerpAngle(angle_, target_angle, 0.1f);
+		Angle() = LerpAngle(Angle(), target_angle, 0.1f);
+	}
 
-		// Regenerate health, provided the cooldown is finished and we are not already at max
-		if (regen_cd.Finished() && health < max_health) {
 
-			// use "steps" to regenerate, i.e. regen one time once a step has finished
-			if (regen_step.Finished()) {
-				regen_step.Start(REGEN_STEP_CD);
-				health += regen_step_amount;
+	/*** Handle the player's timers firing, regen and power-ups no longer need checking every frame ***/
+	void PlayerGameObject::OnTimer(int timer_id) {
+		switch (timer_id) {
 
-				// clamp health to never exceed max_health
-				if (health > max_health) {
-					health = max_health;
+			// Regenerate health in "steps", one step each time the timer fires until we're back at max
+			case TIMER_REGEN:
+				regen_timer = 0;
+				if (Health() > 0 && Health() < max_health) {
+					Health() += regen_step_amount;
+
+					// clamp health to never exceed max_health
+					if (Health() > max_health) {
+						Health() = max_health;
+					}
+					else if (Health() < max_health) {
+						ScheduleRegen(REGEN_STEP_CD);
+					}
 				}
-			}
+				break;
+
+			// Power-up expired, reset its state back to false
+			case TIMER_DOUBLE_POINTS:
+				dp_timer = 0;
+				double_points = false;
+				break;
+			case TIMER_BULLET_BOOST:
+				bb_timer = 0;
+				bullet_boost = false;
+				break;
+			case TIMER_COLD_SHOCK:
+				cs_timer = 0;
+				cold_shock = false;
+				break;
+
+			default:
+				GameObject::OnTimer(timer_id);
+				break;
 		}
+	}
 
-		// Check power-up timers, if expired, reset states back to false
-		if (dp_timer.FinishedAndStop()) {
-			double_points = false;
-		}
-		if (bb_timer.FinishedAndStop()) {
-			bullet_boost = false;
-		}
-		if (cs_timer.FinishedAndStop()) {
-			cold_shock = false;
-		}
+
+	/*** Restart the regen timer, a hit pushes regen back by the full cooldown ***/
+	void PlayerGameObject::ScheduleRegen(float delay) {
+		timers_->Cancel(regen_timer);
+		regen_timer = timers_->Schedule(delay, this, TIMER_REGEN);
+	}
+
+
+	/*** Restart a power-up's timer, picking up the same power-up again resets its duration ***/
+	void PlayerGameObject::StartPowerUpTimer(TimerHandle& handle, int timer_id) {
+		timers_->Cancel(handle);
+		handle = timers_->Schedule(POWER_UP_DURATION, this, timer_id);
 	}
 
 
 	/*** Longer erase timer than default, as this only plays during a game over ***/
 	void PlayerGameObject::StartEraseTimer(void) {
-		erase_timer_.Start(5.0f);
+		SetEraseTime(5.0f);
 	}
 
 
@@ -113,17 +155,17 @@ namespace game {
 	bool PlayerGameObject::TakeDamage(int recieved_dmg) {
 
 		// Ensure damage isn't taken during invincibility frames
-		if (i_frames_timer.Finished() && health > 0) {
-			health -= recieved_dmg;
+		if (i_frames_timer.Finished() && Health() > 0) {
+			Health() -= recieved_dmg;
 
 			// enters if-statement if dead, clamp health to never go below 0
-			if (health < 0) {
-				health = 0;
+			if (Health() < 0) {
+				Health() = 0;
 			}
 
 			// start associated timers if not dead
 			else {
-				regen_cd.Start(regen_cd_time);
+				ScheduleRegen(regen_cd_time);
 				i_frames_timer.Start(INVINCIBILITY_DURATION);
 			}
 
@@ -174,21 +216,21 @@ namespace game {
 	/*** Handle Double Points state and timer ***/
 	void PlayerGameObject::EnableDoublePoints(void) { 
 		double_points = true;
-		dp_timer.Start(POWER_UP_DURATION);
+		StartPowerUpTimer(dp_timer, TIMER_DOUBLE_POINTS);
 	}
 
 
 	/*** Handle Bullet Boost state and timer ***/
 	void PlayerGameObject::EnableBulletBoost(void) {
 		bullet_boost = true;
-		bb_timer.Start(POWER_UP_DURATION);
+		StartPowerUpTimer(bb_timer, TIMER_BULLET_BOOST);
 	}
 
 
 	/*** Handle Cold Shock state and timer ***/
 	void PlayerGameObject::EnableColdShock(void) {
 		cold_shock = true;
-		cs_timer.Start(POWER_UP_DURATION);
+		StartPowerUpTimer(cs_timer, TIMER_COLD_SHOCK);
 	}
 
 	
@@ -196,7 +238,12 @@ namespace game {
 	void PlayerGameObject::EnableArmorPlating(void) {
 		armor_plating = true;
 		max_health = 150; // 50hp increase to max health
-		health *= 1.5;
+		Health() *= 1.5;
+
+		// keep regenerating up to the new max, unless a hit's cooldown is already counting down
+		if (!timers_->IsPending(regen_timer)) {
+			ScheduleRegen(REGEN_STEP_CD);
+		}
 	}
 
 
@@ -15,17 +15,23 @@ namespace game {
         // Constructor
         PlayerGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, const GLuint& texture);
 
+        // Destructor, drops the player's timers from the wheel
+        ~PlayerGameObject();
+
         // Overriden Update function for moving the player object around
         void Update(double delta_time) override;
 
         // Overriden EraseTimer handler, takes longer than the default
         void StartEraseTimer(void) override;
 
+        // Regen steps and power-ups ending, fired by the timer wheel
+        void OnTimer(int timer_id) override;
+
         // Update the target angle, allows for cursor-based rotation
         inline void UpdateTargetAngle(float ta) { target_angle = ta; }
         
         // Health handlers
-        inline unsigned short int GetHealth(void) const { return health; }
+        inline unsigned short int GetHealth(void) const { return GetStoredHealth(); }
         bool TakeDamage(int recieved_dmg);
 
         // Speed handlers
@@ -73,7 +79,6 @@ namespace game {
 
     private:
         // Health member vars
-        short int health;
         short int max_health;
         float regen_cd_time;
         float regen_step_amount;
@@ -82,13 +87,15 @@ namespace game {
         float max_speed;
         float accel_force;
 
-        // Timers for handling player health
+        // Timers for handling player health, regen_timer covers the cooldown after a hit and then each step
         Timer i_frames_timer;
-        Timer regen_cd;
-        Timer regen_step;
+        TimerHandle regen_timer;
         Timer knockback_cooldown;
 
-        // Intended angle, GameObject::angle_ uses linear interpolation to reach this
+        // (Re)start the regen timer
+        void ScheduleRegen(float delay);
+
+        // Intended angle, the rotation uses linear interpolation to reach this
         float target_angle;
 
         // i need more bullets
@@ -100,9 +107,12 @@ namespace game {
 
         // Power-up helpers (limited, on timer)
         bool double_points, bullet_boost, cold_shock;
-        Timer dp_timer;
-        Timer bb_timer;
-        Timer cs_timer;
+        TimerHandle dp_timer;
+        TimerHandle bb_timer;
+        TimerHandle cs_timer;
+
+        // (Re)start a power-up's timer on the wheel
+        void StartPowerUpTimer(TimerHandle& handle, int timer_id);
 
         // Upgrade helpers (permanent, buyable)
         bool armor_plating, regen_coating, nitro_infuse, celestial_augment;
@@ -0,0 +1,151 @@
+// Profiler class definitions
+
+#include <iomanip>
+
+#include "profiler.h"
+
+namespace game {
+
+    // Names printed for each stat, in ProfileStat order
+    static const char* const STAT_NAMES[PROFILE_STAT_COUNT] = {
+        "frame", "render", "present", "simulation", "input latency"
+    };
+
+    // Names printed for each counter, in ProfileCounter order
+    static const char* const COUNTER_NAMES[PROFILE_COUNTER_COUNT] = {
+        "drawn", "culled", "static calls", "static fill",
+        "program binds", "texture binds", "blend changes", "draw calls",
+        "batched sprites", "audio dropped"
+    };
+
+    // What each counter is counted over, in ProfileCounter order
+    static const char* const COUNTER_PERIODS[PROFILE_COUNTER_COUNT] = {
+        "snapshot", "snapshot", "frame", "frame",
+        "frame", "frame", "frame", "frame",
+        "frame", "snapshot"
+    };
+
+
+    /*** Constructor, both windows start out empty ***/
+    Profiler::Profiler(void) {
+        for (int i = 0; i < PROFILE_STAT_COUNT; ++i) {
+            current_[i] = { 0.0, 0.0, 0.0, 0 };
+            last_[i] = current_[i];
+        }
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+            current_counts_[i] = { 0.0, 0.0, 0.0, 0 };
+            last_counts_[i] = current_counts_[i];
+        }
+        current_hitches_ = { 0.0, 0.0, 0.0, 0 };
+        last_hitches_ = current_hitches_;
+        total_hitches_ = 0;
+    }
+
+
+    /*** Add a timing to the current window ***/
+    void Profiler::Record(ProfileStat stat, double seconds) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AddSample(current_[stat], seconds);
+    }
+
+
+    /*** Add a count to the current window ***/
+    void Profiler::RecordCount(ProfileCounter counter, int count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AddSample(current_counts_[counter], count);
+    }
+
+
+    /*** Add a hitch to the current window ***/
+    void Profiler::RecordHitch(double seconds) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AddSample(current_hitches_, seconds);
+        total_hitches_++;
+    }
+
+
+    /*** Get how many hitches there have been ***/
+    int Profiler::GetHitchCount(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return total_hitches_;
+    }
+
+
+    /*** Fold one value into a stat's min/max/total ***/
+    void Profiler::AddSample(Samples& samples, double value) {
+        if (samples.count == 0 || value < samples.min) {
+            samples.min = value;
+        }
+        if (samples.count == 0 || value > samples.max) {
+            samples.max = value;
+        }
+        samples.total += value;
+        samples.count++;
+    }
+
+
+    /*** Finish the current window and start a new one ***/
+    void Profiler::EndWindow(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < PROFILE_STAT_COUNT; ++i) {
+            last_[i] = current_[i];
+            current_[i] = { 0.0, 0.0, 0.0, 0 };
+        }
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+            last_counts_[i] = current_counts_[i];
+            current_counts_[i] = { 0.0, 0.0, 0.0, 0 };
+        }
+        last_hitches_ = current_hitches_;
+        current_hitches_ = { 0.0, 0.0, 0.0, 0 };
+    }
+
+
+    /*** Get the average of a stat over the last window ***/
+    double Profiler::GetAverage(ProfileStat stat) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Samples& samples = last_[stat];
+        return samples.count > 0 ? samples.total / samples.count : 0.0;
+    }
+
+
+    /*** Print min/avg/max of every stat in milliseconds, then of every counter and the hitches ***/
+    void Profiler::Print(std::ostream& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // keep the stream's formatting as it was
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+
+        out << std::fixed << std::setprecision(2);
+        for (int i = 0; i < PROFILE_STAT_COUNT; ++i) {
+            const Samples& samples = last_[i];
+            if (samples.count == 0) {
+                continue;
+            }
+            out << std::setw(14) << STAT_NAMES[i] << ": "
+                << "min " << samples.min * 1000.0 << "ms, "
+                << "avg " << samples.total / samples.count * 1000.0 << "ms, "
+                << "max " << samples.max * 1000.0 << "ms "
+                << "(" << samples.count << " samples)" << std::endl;
+        }
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+            const Samples& samples = last_counts_[i];
+            if (samples.count == 0) {
+                continue;
+            }
+            out << std::setw(14) << COUNTER_NAMES[i] << ": "
+                << "min " << samples.min << ", "
+                << "avg " << samples.total / samples.count << ", "
+                << "max " << samples.max << " per " << COUNTER_PERIODS[i] << std::endl;
+        }
+        if (last_hitches_.count > 0) {
+            out << std::setw(14) << "hitches" << ": "
+                << last_hitches_.count << ", "
+                << "worst " << last_hitches_.max * 1000.0 << "ms "
+                << "(" << total_hitches_ << " so far)" << std::endl;
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+} // namespace game
@@ -0,0 +1,86 @@
+// Profiler class declarations, collects frame timings from both the simulation and render threads
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <iostream>
+#include <mutex>
+
+namespace game {
+
+    // What gets timed, all in seconds
+    enum ProfileStat {
+        PROFILE_FRAME,          // time between presented frames, its spread is the frame pacing
+        PROFILE_RENDER,         // issuing a snapshot's draw calls
+        PROFILE_PRESENT,        // glfwSwapBuffers, mostly waiting on vsync
+        PROFILE_SIMULATION,     // one simulation step, including building its snapshot
+        PROFILE_INPUT_LATENCY,  // input being polled until a frame reacting to it is presented
+        PROFILE_STAT_COUNT
+    };
+
+    // What gets counted, once per snapshot or rendered frame
+    enum ProfileCounter {
+        COUNT_DRAWN,            // objects that made it into the snapshot
+        COUNT_CULLED,           // objects left out for being hidden or off-screen
+        COUNT_STATIC_CALLS_SAVED,   // per rendered frame, background draw calls the static layer cache made unnecessary
+        COUNT_STATIC_FILL_SAVED,    // and pixels, negative when the full-view composite costs more than the sprites
+        COUNT_PROGRAM_BINDS,        // state changes made by the render queue per frame
+        COUNT_TEXTURE_BINDS,
+        COUNT_BLEND_CHANGES,
+        COUNT_DRAW_CALLS,
+        COUNT_BATCHED_SPRITES,      // sprites drawn as part of a batch rather than on their own
+        COUNT_AUDIO_DROPPED,        // per snapshot, audio commands lost to a full queue
+        PROFILE_COUNTER_COUNT
+    };
+
+
+    /* Keeps min/average/max of every stat and counter over a window of time.
+     * Record can be called from any thread, EndWindow is called periodically by one of them */
+    class Profiler {
+
+        public:
+            Profiler(void);
+
+            // Add one sample to a stat
+            void Record(ProfileStat stat, double seconds);
+            void RecordCount(ProfileCounter counter, int count);
+
+            // Note a presented frame that took much longer than the ones before it
+            void RecordHitch(double seconds);
+
+            // Hitches since the start, including the current window
+            int GetHitchCount(void);
+
+            // Close the current window, its results are kept for GetAverage and Print
+            void EndWindow(void);
+
+            // Average of a stat over the last finished window, 0 if it had no samples
+            double GetAverage(ProfileStat stat);
+
+            // Print the last finished window, one line per stat
+            void Print(std::ostream& out);
+
+        private:
+            struct Samples {
+                double total;
+                double min;
+                double max;
+                int count;
+            };
+            static void AddSample(Samples& samples, double value);
+
+            // The window being recorded, and the last finished one
+            Samples current_[PROFILE_STAT_COUNT];
+            Samples last_[PROFILE_STAT_COUNT];
+            Samples current_counts_[PROFILE_COUNTER_COUNT];
+            Samples last_counts_[PROFILE_COUNTER_COUNT];
+            Samples current_hitches_;
+            Samples last_hitches_;
+            int total_hitches_;
+
+            std::mutex mutex_;
+    };
+
+} // namespace game
+
+#endif // PROFILER_H_
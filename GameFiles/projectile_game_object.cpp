@@ -5,24 +5,26 @@
 namespace game {
 
 
-	/*** Constructor ***/
+	/*** Constructor, position may point into the entity store, so it isn't read again once the base has added this object ***/
 	ProjectileGameObject::ProjectileGameObject(
 		const glm::vec3 &position, Geometry* geom, Shader* shader, const GLuint& texture, float lifespan, int damage)
-		: GameObject(position, geom, shader, texture), origin(position), bullet_lifespan(lifespan), damage(damage) {
+		: GameObject(position, geom, shader, texture), origin(GetPosition()), bullet_lifespan(lifespan), damage(damage) {
 
 		// default declarations
-		scale_ = glm::vec2(0.45f);
+		Scale() = glm::vec2(0.45f);
 		time_elapsed = 0.0f;
 		impact_flag = false;
 
 		// start the erase timer, as projectiles should auto-delete
-		erase_timer_.Start(bullet_lifespan);
+		SetEraseTime(bullet_lifespan);
+
+		// flies straight along its velocity, moved by the store's movement system
+		MoveSpeed() = 1.0f;
 	}
 
 
-	/*** Move the projectile based on the velocity member variable ***/
+	/*** Track the projectile's flight time, the store's movement system moves it ***/
 	void ProjectileGameObject::Update(double delta_time) {
-		SetPosition(position_ + velocity_ * static_cast<float>(delta_time));
 		time_elapsed += delta_time;
 	}
 
@@ -18,7 +18,7 @@ namespace game {
         ProjectileGameObject(const glm::vec3& position, Geometry* geom, Shader* shader,
                              const GLuint& texture, float lifespan, int damage);
 
-        // overriden Update method, moves based on velocity vector
+        // overriden Update method, tracks time in flight (movement is done by the entity store)
         void Update(double delta_time) override;
 
         // getters
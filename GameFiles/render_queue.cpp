@@ -0,0 +1,402 @@
+// RenderQueue class definitions
+
+#include <algorithm>
+
+#include "render_queue.h"
+
+namespace game {
+
+    // Width of each part of the sort key, from the least significant end
+    static const int DEPTH_BITS = 16;
+    static const int TEXTURE_BITS = 20;
+    static const int PROGRAM_BITS = 16;
+    static const int BLEND_BITS = 4;
+
+    static const int TEXTURE_SHIFT = DEPTH_BITS;
+    static const int PROGRAM_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+    static const int BLEND_SHIFT = PROGRAM_SHIFT + PROGRAM_BITS;
+    static const int LAYER_SHIFT = BLEND_SHIFT + BLEND_BITS;
+
+    // Corners of the sprite quad as Sprite::CreateGeometry lays them out: position, color, texture coordinates
+    static const int BATCH_CORNER_FLOATS = 7;
+    static const GLfloat BATCH_CORNERS[4][BATCH_CORNER_FLOATS] = {
+        { -0.5f,  0.5f,    1.0f, 0.0f, 0.0f,    0.0f, 0.0f },
+        {  0.5f,  0.5f,    0.0f, 1.0f, 0.0f,    1.0f, 0.0f },
+        {  0.5f, -0.5f,    0.0f, 0.0f, 1.0f,    1.0f, 1.0f },
+        { -0.5f, -0.5f,    1.0f, 1.0f, 1.0f,    0.0f, 1.0f }
+    };
+
+    // Batched vertices are the same with the depth after the position
+    static const int BATCH_VERTEX_FLOATS = BATCH_CORNER_FLOATS + 1;
+
+
+    /*** Pick the pass's variant ***/
+    GLuint ScreenPassInstance::SelectProgram(void) const {
+        shader->SelectVariant(variant);
+        return shader->GetShaderProgram();
+    }
+
+
+    /*** Set the pass's uniforms, whichever the variant doesn't have are ignored, and draw its one triangle ***/
+    void ScreenPassInstance::DrawInstance(void) const {
+        shader->SetUniform2f("vignette_center", vignette_center);
+        shader->SetUniform1f("world_half_size", world_half_size);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+
+    /*** Constructor, without batching ***/
+    RenderQueue::RenderQueue(void) : batch_quad_(NULL), stream_(NULL), batch_ebo_(0) {}
+
+
+    /*** Destructor ***/
+    RenderQueue::~RenderQueue() {
+        glDeleteBuffers(1, &batch_ebo_);
+    }
+
+
+    /*** Make the index buffer every batch draws with, the quads' vertices come from the stream each frame ***/
+    void RenderQueue::InitBatching(Geometry* quad, StreamRing* stream) {
+        batch_quad_ = quad;
+        stream_ = stream;
+
+        std::vector<GLuint> indices(SPRITE_BATCH_MAX * 6);
+        for (GLuint q = 0; q < SPRITE_BATCH_MAX; ++q) {
+            GLuint first = q * 4;
+            GLuint face[] = { first, first + 1, first + 2, first + 2, first + 3, first };
+            std::copy(face, face + 6, indices.begin() + q * 6);
+        }
+
+        glGenBuffers(1, &batch_ebo_);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch_ebo_);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    }
+
+
+    /*** Empty the queue ***/
+    void RenderQueue::Clear(void) {
+        commands_.clear();
+    }
+
+
+    /*** Assorted Submits, the instance picks its program variant now so it can go in the key ***/
+    void RenderQueue::Submit(RenderLayer layer, BlendMode blend, const SpriteInstance* sprite) {
+        Push(layer, blend, sprite->SelectProgram(), sprite->texture, COMMAND_SPRITE, sprite);
+    }
+    void RenderQueue::Submit(RenderLayer layer, BlendMode blend, const TextInstance* text) {
+        Push(layer, blend, text->SelectProgram(), text->texture, COMMAND_TEXT, text);
+    }
+    void RenderQueue::Submit(RenderLayer layer, BlendMode blend, const ParticleInstance* particles) {
+        Push(layer, blend, particles->SelectProgram(), particles->texture, COMMAND_PARTICLES, particles);
+    }
+    void RenderQueue::Submit(RenderLayer layer, BlendMode blend, const ScreenPassInstance* pass) {
+        Push(layer, blend, pass->SelectProgram(), 0, COMMAND_SCREEN, pass);
+    }
+
+
+    /*** Pack the key, GL names past a field's width only cost some sorting, never correctness ***/
+    void RenderQueue::Push(RenderLayer layer, BlendMode blend, GLuint program, GLuint texture, CommandType type, const void* instance) {
+        unsigned long long depth = commands_.size();
+        if (depth >= (1ull << DEPTH_BITS)) {
+            depth = (1ull << DEPTH_BITS) - 1;
+        }
+
+        Command command;
+        command.key = ((unsigned long long)layer << LAYER_SHIFT)
+            | ((unsigned long long)blend << BLEND_SHIFT)
+            | (((unsigned long long)program & ((1ull << PROGRAM_BITS) - 1)) << PROGRAM_SHIFT)
+            | (((unsigned long long)texture & ((1ull << TEXTURE_BITS) - 1)) << TEXTURE_SHIFT)
+            | depth;
+        command.type = type;
+        command.instance = instance;
+        command.z = 0.0f;
+        command.opaque_only = false;
+        commands_.push_back(command);
+    }
+
+
+    /*** Sort by key, eight counting passes at most ***/
+    void RenderQueue::Sort(std::vector<Command>& commands) {
+        scratch_.resize(commands.size());
+
+        for (int shift = 0; shift < 64; shift += 8) {
+
+            // Count each byte value
+            int counts[256] = { 0 };
+            for (int i = 0; i < commands.size(); ++i) {
+                counts[(commands[i].key >> shift) & 0xFF]++;
+            }
+
+            // Every key has the same byte here, so this pass wouldn't move anything
+            if (counts[(commands[0].key >> shift) & 0xFF] == commands.size()) {
+                continue;
+            }
+
+            // Turn the counts into where each byte value starts, then scatter in order
+            int offset = 0;
+            for (int b = 0; b < 256; ++b) {
+                int count = counts[b];
+                counts[b] = offset;
+                offset += count;
+            }
+            for (int i = 0; i < commands.size(); ++i) {
+                scratch_[counts[(commands[i].key >> shift) & 0xFF]++] = commands[i];
+            }
+            commands.swap(scratch_);
+        }
+    }
+
+
+    /*** Sprites batch while they share everything in the key but depth, sit on the shared quad and use the same shader ***/
+    int RenderQueue::BatchLength(const std::vector<Command>& commands, int first) const {
+        if (!stream_ || commands[first].type != COMMAND_SPRITE) {
+            return 1;
+        }
+        const SpriteInstance* sprite = (const SpriteInstance*)commands[first].instance;
+        if (sprite->geometry != batch_quad_) {
+            return 1;
+        }
+
+        int last = first + 1;
+        while (last < commands.size() && last - first < SPRITE_BATCH_MAX) {
+            const Command& next = commands[last];
+            if (next.type != COMMAND_SPRITE || (next.key >> TEXTURE_SHIFT) != (commands[first].key >> TEXTURE_SHIFT)) {
+                break;
+            }
+
+            // the key only holds the low bits of the GL names, so make sure of the real state
+            const SpriteInstance* other = (const SpriteInstance*)next.instance;
+            if (other->geometry != batch_quad_ || other->shader != sprite->shader
+                || other->texture != sprite->texture || other->ghost != sprite->ghost) {
+                break;
+            }
+            last++;
+        }
+        return last - first;
+    }
+
+
+    /*** Transform each sprite's corners into the stream with its depth, false if the frame's stream is full ***/
+    bool RenderQueue::WriteBatch(const std::vector<Command>& commands, int first, int count, GLintptr& offset) {
+        const GLsizeiptr vertex_size = BATCH_VERTEX_FLOATS * sizeof(GLfloat);
+        GLfloat* out = (GLfloat*)stream_->Allocate(count * 4 * vertex_size, vertex_size, offset);
+        if (!out) {
+            return false;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const Command& command = commands[first + i];
+            const glm::mat4& transform = ((const SpriteInstance*)command.instance)->transform;
+            for (int c = 0; c < 4; ++c) {
+                glm::vec4 position = transform * glm::vec4(BATCH_CORNERS[c][0], BATCH_CORNERS[c][1], 0.0f, 1.0f);
+                out[0] = position.x;
+                out[1] = position.y;
+                out[2] = command.z;
+                std::copy(BATCH_CORNERS[c] + 2, BATCH_CORNERS[c] + BATCH_CORNER_FLOATS, out + 3);
+                out += BATCH_VERTEX_FLOATS;
+            }
+        }
+        stream_->Commit();
+        return true;
+    }
+
+
+    /*** Point the attributes at the written vertices, like Sprite::SetGeometry does at its own buffer, and draw them all ***/
+    void RenderQueue::DrawBatch(const SpriteInstance* sprite, GLuint program, GLintptr offset, int count) {
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LESS);
+        glEnable(GL_BLEND);
+
+        glBindBuffer(GL_ARRAY_BUFFER, stream_->GetBuffer());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch_ebo_);
+
+        const GLsizei stride = BATCH_VERTEX_FLOATS * sizeof(GLfloat);
+        GLint vertex_att = glGetAttribLocation(program, "vertex");
+        glVertexAttribPointer(vertex_att, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        glEnableVertexAttribArray(vertex_att);
+
+        GLint color_att = glGetAttribLocation(program, "color");
+        if (color_att >= 0) {
+            glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 3 * sizeof(GLfloat)));
+            glEnableVertexAttribArray(color_att);
+        }
+
+        GLint tex_att = glGetAttribLocation(program, "uv");
+        glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 6 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(tex_att);
+
+        // the vertices are already in world space and carry their own depth
+        sprite->shader->SetUniformMat4("transformation_matrix", glm::mat4(1.0f));
+        sprite->shader->SetUniform1f("depth", 0.0f);
+        glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT, 0);
+    }
+
+
+    /*** Give every draw its depth from the painter's order, then draw the opaque pass and the blended one ***/
+    RenderStats RenderQueue::Execute(void) {
+        RenderStats stats = { 0, 0, 0, 0, 0 };
+        if (commands_.empty()) {
+            return stats;
+        }
+        Sort(commands_);
+
+        // Later draws are nearer, spread over the clip range so each one gets a depth of its own
+        float step = 2.0f / (commands_.size() + 1);
+        for (int i = 0; i < commands_.size(); ++i) {
+            commands_[i].z = 1.0f - (i + 1) * step;
+        }
+
+        // Nothing is assumed to be bound yet, other code may have drawn since the last Execute
+        PassState state = { -1, 0, NULL, 0, false };
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LESS);
+
+        if (OPAQUE_DEPTH_PASS) {
+
+            /* Opaque pass, the sprites' fully covered texels and the sky. The layers go front to back
+             * and inside one the draws are sorted by state, the depth test sorts out what's in front
+             * so sprites batch no matter where they were submitted. Draws sharing their state still
+             * go nearest first */
+            opaque_.clear();
+            for (int i = 0; i < commands_.size(); ++i) {
+                Command& command = commands_[i];
+                RenderLayer layer = (RenderLayer)(command.key >> LAYER_SHIFT);
+                if (command.type != COMMAND_SPRITE && layer != RENDER_LAYER_SKY) {
+                    continue;
+                }
+
+                Command opaque = command;
+                GLuint program = command.type == COMMAND_SPRITE
+                    ? ((const SpriteInstance*)command.instance)->SelectProgram(true)
+                    : ((const ScreenPassInstance*)command.instance)->SelectProgram();
+                GLuint texture = command.type == COMMAND_SPRITE ? ((const SpriteInstance*)command.instance)->texture : 0;
+                unsigned long long order = std::min(commands_.size() - 1 - i, (size_t)(1ull << DEPTH_BITS) - 1);
+                opaque.key = ((unsigned long long)(RENDER_LAYER_HUD - layer) << LAYER_SHIFT)
+                    | ((unsigned long long)BLEND_PREMULTIPLIED << BLEND_SHIFT)
+                    | (((unsigned long long)program & ((1ull << PROGRAM_BITS) - 1)) << PROGRAM_SHIFT)
+                    | (((unsigned long long)texture & ((1ull << TEXTURE_BITS) - 1)) << TEXTURE_SHIFT)
+                    | order;
+                opaque_.push_back(opaque);
+
+                // the sky is opaque wherever it draws, so it's done with after this pass
+                command.opaque_only = command.type != COMMAND_SPRITE;
+            }
+
+            if (!opaque_.empty()) {
+                Sort(opaque_);
+                glDepthMask(GL_TRUE);
+                Issue(opaque_, true, state, stats);
+            }
+        }
+
+        // Blended pass back to front without writing depth, whatever the opaque pass covered fails the depth test
+        glDepthMask(GL_FALSE);
+        Issue(commands_, false, state, stats);
+
+        if (state.blend != BLEND_PREMULTIPLIED) {
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        }
+        return stats;
+    }
+
+
+    /*** Draw a pass in order, binding only what changed since the last draw ***/
+    void RenderQueue::Issue(const std::vector<Command>& commands, bool opaque, PassState& state, RenderStats& stats) {
+        for (int i = 0; i < commands.size(); ++i) {
+            const Command& command = commands[i];
+            if (!opaque && command.opaque_only) {
+                continue;
+            }
+
+            int command_blend = (int)((command.key >> BLEND_SHIFT) & ((1ull << BLEND_BITS) - 1));
+            if (command_blend != state.blend) {
+                glBlendFunc(GL_ONE, command_blend == BLEND_ADDITIVE ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+                state.blend = command_blend;
+                stats.blend_changes++;
+            }
+
+            // Each type selects its variant again (another command may have changed it) and has its own state
+            Shader* shader;
+            GLuint command_program;
+            Geometry* command_geometry = NULL;
+            GLuint command_texture = 0;
+            switch (command.type) {
+                case COMMAND_SPRITE: {
+                    const SpriteInstance* sprite = (const SpriteInstance*)command.instance;
+                    shader = sprite->shader;
+                    command_program = sprite->SelectProgram(opaque);
+                    command_geometry = sprite->geometry;
+                    command_texture = sprite->texture;
+                    break;
+                }
+                case COMMAND_TEXT: {
+                    const TextInstance* text = (const TextInstance*)command.instance;
+                    shader = text->shader;
+                    command_program = text->SelectProgram();
+                    command_geometry = text->geometry;
+                    command_texture = text->texture;
+                    break;
+                }
+                case COMMAND_PARTICLES: {
+                    const ParticleInstance* particles = (const ParticleInstance*)command.instance;
+                    shader = particles->shader;
+                    command_program = particles->SelectProgram();
+                    command_geometry = particles->geometry;
+                    command_texture = particles->texture;
+                    break;
+                }
+                default: {
+                    const ScreenPassInstance* pass = (const ScreenPassInstance*)command.instance;
+                    shader = pass->shader;
+                    command_program = pass->SelectProgram();
+                    break;
+                }
+            }
+
+            // Attribute locations belong to the program, so a new program means setting up the geometry again
+            if (command_program != state.program) {
+                shader->Enable();
+                state.program = command_program;
+                state.geometry = NULL;
+                stats.program_binds++;
+            }
+
+            // A run of sprites goes into the stream, or one by one if it's full
+            int batch = BatchLength(commands, i);
+            GLintptr batch_offset = 0;
+            if (batch > 1 && !WriteBatch(commands, i, batch, batch_offset)) {
+                batch = 1;
+            }
+
+            if (batch == 1 && command_geometry && command_geometry != state.geometry) {
+                command_geometry->SetGeometry(state.program);
+                state.geometry = command_geometry;
+            }
+            if (command.type != COMMAND_SCREEN && (!state.texture_bound || command_texture != state.texture)) {
+                glBindTexture(GL_TEXTURE_2D, command_texture);
+                state.texture = command_texture;
+                state.texture_bound = true;
+                stats.texture_binds++;
+            }
+
+            if (batch > 1) {
+                DrawBatch((const SpriteInstance*)command.instance, state.program, batch_offset, batch);
+                state.geometry = NULL;
+                stats.batched_sprites += batch;
+                stats.draw_calls++;
+                i += batch - 1;
+                continue;
+            }
+
+            shader->SetUniform1f("depth", command.z);
+            switch (command.type) {
+                case COMMAND_SPRITE: ((const SpriteInstance*)command.instance)->DrawInstance(); break;
+                case COMMAND_TEXT: ((const TextInstance*)command.instance)->DrawInstance(); break;
+                case COMMAND_PARTICLES: ((const ParticleInstance*)command.instance)->DrawInstance(); break;
+                default: ((const ScreenPassInstance*)command.instance)->DrawInstance(); break;
+            }
+            stats.draw_calls++;
+        }
+    }
+
+} // namespace game
@@ -0,0 +1,134 @@
+// RenderQueue class declarations, collects a frame's draws and issues them sorted to avoid state changes
+
+#ifndef RENDER_QUEUE_H_
+#define RENDER_QUEUE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "render_snapshot.h"
+#include "shader.h"
+#include "stream_ring.h"
+
+namespace game {
+
+    // Draw order, a layer is finished before the next one starts
+    enum RenderLayer {
+        RENDER_LAYER_SKY,           // the starfield
+        RENDER_LAYER_STATIC,        // background sprites, or the static layer cache standing in for them
+        RENDER_LAYER_WORLD,         // particles, then everything in the snapshot's foreground
+        RENDER_LAYER_VIGNETTE,
+        RENDER_LAYER_TEXT,
+        RENDER_LAYER_HUD
+    };
+
+    // Blend state, sorted in this order inside a layer so particles stay under the sprites
+    enum BlendMode {
+        BLEND_ADDITIVE,             // GL_ONE, GL_ONE
+        BLEND_PREMULTIPLIED         // GL_ONE, GL_ONE_MINUS_SRC_ALPHA, the default
+    };
+
+    // A full-screen pass of the screen shader (no geometry or texture), see screen_fragment_shader.glsl
+    struct ScreenPassInstance {
+        Shader* shader;
+        unsigned int variant;
+        glm::vec2 vignette_center;
+        float world_half_size;
+
+        GLuint SelectProgram(void) const;
+        void DrawInstance(void) const;
+    };
+
+    // State changes and draws made by one Execute
+    struct RenderStats {
+        int program_binds;
+        int texture_binds;
+        int blend_changes;
+        int draw_calls;
+        int batched_sprites;
+    };
+
+
+    /* Draws are submitted with a 64-bit sort key, from the most significant bits down:
+     *   layer (8) | blend (4) | program (16) | texture (20) | depth (16)
+     * Execute radix sorts them once, then walks them only binding a program, geometry,
+     * texture or blend state when it differs from the last draw's. depth is the submission
+     * order, so draws that share everything else keep the order they were submitted in.
+     * That sorted order is the painter's order, and each draw gets a depth from its place in
+     * it. With OPAQUE_DEPTH_PASS the sprites' opaque texels and the sky are drawn first, front
+     * to back with depth writes, then everything is drawn back to front with blending and
+     * only what's still visible gets past the depth test.
+     * Once batching is set up, runs of sprites on the shared quad that only differ in depth
+     * are transformed on the CPU into the stream ring and drawn with one call.
+     * Instances are kept by pointer and have to stay alive until Execute. Main thread only */
+    class RenderQueue {
+
+        public:
+            RenderQueue(void);
+            ~RenderQueue();
+
+            // Batch sprites drawn with this quad, writing their vertices into the stream (which has to outlive the queue)
+            void InitBatching(Geometry* quad, StreamRing* stream);
+
+            // Forget the last frame's commands, keeping their memory
+            void Clear(void);
+
+            // Queue a draw
+            void Submit(RenderLayer layer, BlendMode blend, const SpriteInstance* sprite);
+            void Submit(RenderLayer layer, BlendMode blend, const TextInstance* text);
+            void Submit(RenderLayer layer, BlendMode blend, const ParticleInstance* particles);
+            void Submit(RenderLayer layer, BlendMode blend, const ScreenPassInstance* pass);
+
+            // Sort and draw everything queued, leaves the blend state at BLEND_PREMULTIPLIED and depth writes off
+            RenderStats Execute(void);
+
+        private:
+            enum CommandType { COMMAND_SPRITE, COMMAND_TEXT, COMMAND_PARTICLES, COMMAND_SCREEN };
+
+            struct Command {
+                unsigned long long key;
+                CommandType type;
+                const void* instance;
+                float z;                // clip space depth, nearer is lower
+                bool opaque_only;       // fully drawn by the opaque pass, left out of the blended one
+            };
+
+            // What's bound, carried from one pass into the next
+            struct PassState {
+                int blend;
+                GLuint program;
+                const Geometry* geometry;
+                GLuint texture;
+                bool texture_bound;
+            };
+
+            // Build a key and queue the command
+            void Push(RenderLayer layer, BlendMode blend, GLuint program, GLuint texture, CommandType type, const void* instance);
+
+            // Stable LSD radix sort by key, a byte at a time, skipping bytes every key shares
+            void Sort(std::vector<Command>& commands);
+
+            // Draw a sorted pass, with the sprites' opaque variant for the opaque pass
+            void Issue(const std::vector<Command>& commands, bool opaque, PassState& state, RenderStats& stats);
+
+            // How many sprite commands from first on can go in one batch, and writing/drawing them
+            int BatchLength(const std::vector<Command>& commands, int first) const;
+            bool WriteBatch(const std::vector<Command>& commands, int first, int count, GLintptr& offset);
+            void DrawBatch(const SpriteInstance* sprite, GLuint program, GLintptr offset, int count);
+
+            std::vector<Command> commands_;
+            std::vector<Command> opaque_;
+            std::vector<Command> scratch_;
+
+            // Sprite batching, off until InitBatching, with the indices of SPRITE_BATCH_MAX quads
+            Geometry* batch_quad_;
+            StreamRing* stream_;
+            GLuint batch_ebo_;
+
+    }; // class RenderQueue
+
+} // namespace game
+
+#endif // RENDER_QUEUE_H_
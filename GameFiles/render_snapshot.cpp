@@ -0,0 +1,132 @@
+// RenderSnapshot definitions, drawing of the snapshot instances and the hand-off between threads
+
+#include <utility>
+
+#include "render_snapshot.h"
+
+namespace game {
+
+    /*** Draw a sprite, same as GameObject used to but from the copied transform, the view is in the frame uniforms ***/
+    void SpriteInstance::Draw(bool opaque) const {
+
+        // Set up the shader, geometry and texture, then draw
+        GLuint program = SelectProgram(opaque);
+        shader->Enable();
+        geometry->SetGeometry(program);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        DrawInstance();
+    }
+
+
+    /*** Ghosts have a shader variant of their own, and so does the opaque pass ***/
+    GLuint SpriteInstance::SelectProgram(bool opaque) const {
+        shader->SelectVariant((ghost ? SPRITE_VARIANT_GHOST : 0) | (opaque ? SPRITE_VARIANT_OPAQUE : 0));
+        return shader->GetShaderProgram();
+    }
+
+
+    /*** Set the transform and draw, everything else is already bound ***/
+    void SpriteInstance::DrawInstance(void) const {
+        shader->SetUniformMat4("transformation_matrix", transform);
+        glDrawElements(GL_TRIANGLES, geometry->GetSize(), GL_UNSIGNED_INT, 0);
+    }
+
+
+    /*** Draw a string of text ***/
+    void TextInstance::Draw(void) const {
+
+        // Set up the shader, geometry and font texture, then draw
+        GLuint program = SelectProgram();
+        shader->Enable();
+        geometry->SetGeometry(program);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        DrawInstance();
+    }
+
+
+    /*** Empty text shows the font texture as is ***/
+    GLuint TextInstance::SelectProgram(void) const {
+        shader->SelectVariant(length > 0 ? TEXT_VARIANT_GLYPHS : 0);
+        return shader->GetShaderProgram();
+    }
+
+
+    /*** Set the transform and text data, then draw ***/
+    void TextInstance::DrawInstance(void) const {
+        shader->SetUniformMat4("transformation_matrix", transform);
+        if (length > 0) {
+            shader->SetUniform1i("text_len", length);
+            shader->SetUniformIntArray("text_content", length, content);
+        }
+        glDrawElements(GL_TRIANGLES, geometry->GetSize(), GL_UNSIGNED_INT, 0);
+    }
+
+
+    /*** Draw a particle emitter ***/
+    void ParticleInstance::Draw(void) const {
+
+        // Set up the shader, geometry and texture, then draw
+        GLuint program = SelectProgram();
+        shader->Enable();
+        geometry->SetGeometry(program);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        DrawInstance();
+    }
+
+
+    /*** Particle shaders have no variants ***/
+    GLuint ParticleInstance::SelectProgram(void) const {
+        return shader->GetShaderProgram();
+    }
+
+
+    /*** Set the transform and draw ***/
+    void ParticleInstance::DrawInstance(void) const {
+        shader->SetUniformMat4("transformation_matrix", transform);
+        glDrawElements(GL_TRIANGLES, geometry->GetSize(), GL_UNSIGNED_INT, 0);
+    }
+
+
+    /*** Empty the snapshot, vectors keep their capacity so steady frames don't allocate ***/
+    void RenderSnapshot::Clear(void) {
+        for (int i = 0; i < SNAPSHOT_LAYER_COUNT; ++i) {
+            sprites[i].clear();
+        }
+        texts.clear();
+        particles.clear();
+    }
+
+
+    /*** Constructor, all three slots start out empty ***/
+    SnapshotBuffer::SnapshotBuffer(void)
+        : write_(0), ready_(1), read_(2), fresh_(false), published_(false) {}
+
+
+    /*** Get the snapshot the simulation should fill in next ***/
+    RenderSnapshot& SnapshotBuffer::BeginWrite(void) {
+        RenderSnapshot& snapshot = slots_[write_];
+        snapshot.Clear();
+        return snapshot;
+    }
+
+
+    /*** Make the written snapshot the newest one, the old newest one gets written over next ***/
+    void SnapshotBuffer::Publish(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(write_, ready_);
+        fresh_ = true;
+        published_ = true;
+    }
+
+
+    /*** Take the newest snapshot, or keep drawing the current one if nothing new came in ***/
+    const RenderSnapshot* SnapshotBuffer::Acquire(void) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fresh_) {
+            std::swap(read_, ready_);
+            fresh_ = false;
+        }
+        return published_ ? &slots_[read_] : NULL;
+    }
+
+} // namespace game
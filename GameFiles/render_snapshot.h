@@ -0,0 +1,122 @@
+// RenderSnapshot declarations, an immutable copy of everything that gets drawn in a frame.
+// The simulation thread fills one in, the render thread draws it, and they never touch the same one
+
+#ifndef RENDER_SNAPSHOT_H_
+#define RENDER_SNAPSHOT_H_
+
+#define GLEW_STATIC
+
+#include <vector>
+#include <mutex>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "geometry.h"
+#include "defs.h"
+
+namespace game {
+
+    // Sprite layers, drawn in this order with particles between the background and
+    // foreground and all the text between the foreground and the HUD
+    enum SnapshotLayer { LAYER_BACKGROUND, LAYER_FOREGROUND, LAYER_HUD, SNAPSHOT_LAYER_COUNT };
+
+    // Shader variant keys, bits in the order the variant flags are given to Shader::Begin in Game::Init
+    const unsigned int SPRITE_VARIANT_GHOST = 1;
+    const unsigned int SPRITE_VARIANT_OPAQUE = 2;
+    const unsigned int TEXT_VARIANT_GLYPHS = 1;
+    const unsigned int SCREEN_VARIANT_VIGNETTE = 1;
+
+    // A textured quad, everything the render thread needs to draw one GameObject
+    struct SpriteInstance {
+        Shader* shader;
+        Geometry* geometry;
+        GLuint texture;
+        glm::mat4 transform;
+        bool ghost;
+
+        // Draw with all its state set up. The render queue instead picks the program itself and only
+        // binds what changed, then calls DrawInstance to set the per-instance uniforms and draw.
+        // opaque picks the variant that only draws fully covered texels, for the depth pass
+        void Draw(bool opaque = false) const;
+        GLuint SelectProgram(bool opaque = false) const;
+        void DrawInstance(void) const;
+    };
+
+    // A string drawn with the font texture, the characters are copied so the object can change freely
+    struct TextInstance {
+        Shader* shader;
+        Geometry* geometry;
+        GLuint texture;
+        glm::mat4 transform;
+        int length;
+        GLint content[MAX_TEXT_LENGTH];
+
+        void Draw(void) const;
+        GLuint SelectProgram(void) const;
+        void DrawInstance(void) const;
+    };
+
+    // A particle emitter, animated on the render thread's clock so it stays smooth between snapshots
+    struct ParticleInstance {
+        Shader* shader;
+        Geometry* geometry;
+        GLuint texture;
+        glm::mat4 transform;
+
+        void Draw(void) const;
+        GLuint SelectProgram(void) const;
+        void DrawInstance(void) const;
+    };
+
+    // One frame's worth of draw data. input_time is when the input this frame reacted to was
+    // polled, and publish_time is when the simulation finished it, both used for profiling
+    struct RenderSnapshot {
+        glm::vec3 camera_pos;
+        glm::vec3 vignette_center;
+        double input_time;
+        double publish_time;
+
+        std::vector<SpriteInstance> sprites[SNAPSHOT_LAYER_COUNT];
+        std::vector<TextInstance> texts;
+        std::vector<ParticleInstance> particles;
+
+        // Empty every list, keeping their memory for the next frame
+        void Clear(void);
+    };
+
+
+    /* Hands snapshots from the simulation thread to the render thread. Three
+     * are kept so neither side ever waits on the other: one being written, one
+     * being drawn, and the newest finished one in between. Frames the render
+     * thread is too slow to draw are skipped, never queued up */
+    class SnapshotBuffer {
+
+        public:
+            SnapshotBuffer(void);
+
+            // Simulation side, clear and fill the returned snapshot then publish it
+            RenderSnapshot& BeginWrite(void);
+            void Publish(void);
+
+            /* Render side, returns the newest published snapshot, which stays
+             * valid until the next call. NULL until the first publish */
+            const RenderSnapshot* Acquire(void);
+
+        private:
+            RenderSnapshot slots_[3];
+            int write_;
+            int ready_;
+            int read_;
+
+            // Whether ready_ holds a snapshot that hasn't been acquired yet, and whether any has been published
+            bool fresh_;
+            bool published_;
+
+            // Only guards the three indices, held for a swap and nothing else
+            std::mutex mutex_;
+    };
+
+} // namespace game
+
+#endif // RENDER_SNAPSHOT_H_
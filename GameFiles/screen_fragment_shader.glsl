@@ -0,0 +1,71 @@
+// Source code of fragment shader for full-screen passes. Without VIGNETTE it draws the starfield
+// background, with it the darkness around the player, both worked out instead of sampled from a texture
+#version 130
+
+#include "frame_uniforms.glsl"
+
+// Attributes passed from the vertex shader
+in vec2 world_pos;
+
+#ifdef VIGNETTE
+
+// Player position, fully lit there and fully dark dark_radius away (matches the old vignette.png)
+uniform vec2 vignette_center;
+const float dark_radius = 6.3;
+
+void main()
+{
+    float darkness = smoothstep(0.0, dark_radius, distance(world_pos, vignette_center));
+
+    // Pre-multiplied black, so it only darkens what's under it
+    gl_FragColor = vec4(0.0, 0.0, 0.0, darkness);
+}
+
+#else
+
+// Half the side of the world, nothing is drawn past it
+uniform float world_half_size;
+
+// Star layers, each one further back is sparser, dimmer and moves less with the camera
+const int layer_count = 3;
+const float cell_size = 0.6;        // world units per star cell on the front layer
+const float star_density = 0.35;    // chance a cell has a star
+
+// Pseudo-random number in [0, 1) for a cell
+float Hash(vec2 p)
+{
+    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
+}
+
+// Light from the star of the cell pos is in, if it has one
+vec3 Star(vec2 pos, float seed)
+{
+    vec2 cell = floor(pos) + seed;
+    vec2 center = vec2(Hash(cell + 17.0), Hash(cell + 43.0)) * 0.8 + 0.1;
+    float size = 0.04 + 0.05 * Hash(cell + 71.0);
+    float glow = 1.0 - smoothstep(0.0, size, length(fract(pos) - center));
+    vec3 tint = mix(vec3(0.75, 0.8, 1.0), vec3(1.0, 0.85, 0.7), Hash(cell + 5.0));
+    return tint * glow * step(Hash(cell), star_density);
+}
+
+void main()
+{
+    if (abs(world_pos.x) > world_half_size || abs(world_pos.y) > world_half_size) {
+        discard;
+    }
+
+    // Faint nebula, a few slow waves of blue and purple
+    vec3 color = vec3(0.01, 0.01, 0.04)
+        + vec3(0.015, 0.0, 0.03) * (sin(world_pos.x * 0.35 + sin(world_pos.y * 0.21)) + 1.0)
+        + vec3(0.0, 0.01, 0.03) * (sin(world_pos.y * 0.27 + 2.0 + sin(world_pos.x * 0.17)) + 1.0);
+
+    for (int i = 0; i < layer_count; ++i) {
+        float depth = 1.0 - 0.25 * float(i);
+        vec2 layer_pos = (world_pos - camera_pos.xy * (1.0 - depth)) / (cell_size * depth);
+        color += Star(layer_pos, float(i) * 13.0) * depth;
+    }
+
+    gl_FragColor = vec4(color, 1.0);
+}
+
+#endif
@@ -0,0 +1,18 @@
+// Source code of vertex shader for full-screen passes, one triangle covering the viewport with no vertex buffer
+#version 130
+
+#include "frame_uniforms.glsl"
+uniform float depth;
+
+// World position under each fragment
+out vec2 world_pos;
+
+void main()
+{
+    // Vertices 0, 1, 2 go to (-1,-1), (3,-1), (-1,3), whatever is past the corners gets clipped
+    vec2 clip_pos = vec2(float((gl_VertexID & 1) * 4 - 1), float((gl_VertexID >> 1) * 4 - 1));
+    gl_Position = vec4(clip_pos, depth, 1.0);
+
+    // The view only scales and translates, so undo it one axis at a time
+    world_pos = clip_pos / vec2(view_matrix[0][0], view_matrix[1][1]) + camera_pos.xy;
+}
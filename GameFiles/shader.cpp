@@ -6,79 +6,140 @@ namespace game {
 
     /*** Constructor, only initializes a variable as everythign else is done by Init() ***/
     Shader::Shader(void) {
-        shader_program_ = 0;
+        current_ = 0;
     }
 
 
     /*** Destructor, frees memory ***/
     Shader::~Shader() {
-        glDeleteProgram(shader_program_);
+        for (int i = 0; i < variants_.size(); ++i) {
+            glDeleteProgram(variants_[i].program);
+        }
     }
 
 
-    /*** Initialize shader for proper use ***/
+    /*** Initialize shader for proper use, without a cache ***/
     void Shader::Init(const char *vertPath, const char *fragPath) {
+        ShaderCache no_cache;
+        Begin(vertPath, fragPath, no_cache);
+        Finish(no_cache);
+    }
 
-        // Load shader program source code
-        // Vertex program
-        std::string vp = LoadTextFile(vertPath);
-        const char *source_vp = vp.c_str();
-        // Fragment program
-        std::string fp = LoadTextFile(fragPath);
-        const char *source_fp = fp.c_str();
-
-        // Create a shader from vertex program source code
-        GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vs, 1, &source_vp, NULL);
-        glCompileShader(vs);
-
-        // Check if shader compiled successfully
-        GLint status;
-        glGetShaderiv(vs, GL_COMPILE_STATUS, &status);
-        if (status != GL_TRUE) {
-            char buffer[512];
-            glGetShaderInfoLog(vs, 512, NULL, buffer);
-            throw(std::ios_base::failure(std::string("Error compiling vertex shader: ") + std::string(buffer)));
-        }
 
-        // Create a shader from the fragment program source code
-        GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fs, 1, &source_fp, NULL);
-        glCompileShader(fs);
-
-        // Check if shader compiled successfully
-        glGetShaderiv(fs, GL_COMPILE_STATUS, &status);
-        if (status != GL_TRUE) {
-            char buffer[512];
-            glGetShaderInfoLog(fs, 512, NULL, buffer);
-            throw(std::ios_base::failure(std::string("Error compiling fragment shader: ") + std::string(buffer)));
+    /*** Load each variant from the cache, or submit it for compiling, nothing here waits on the driver ***/
+    void Shader::Begin(const char *vertPath, const char *fragPath, ShaderCache& cache,
+        const std::vector<std::string>& defines, const std::vector<std::string>& variant_flags) {
+
+        variants_.resize(1u << variant_flags.size());
+        current_ = 0;
+        for (unsigned int key = 0; key < variants_.size(); ++key) {
+            Variant& variant = variants_[key];
+            variant.vertex_shader = 0;
+            variant.fragment_shader = 0;
+
+            // Defines of this variant, the shared ones then the flags in its key
+            std::vector<std::string> variant_defines = defines;
+            for (int i = 0; i < variant_flags.size(); ++i) {
+                if (key & (1u << i)) {
+                    variant_defines.push_back(variant_flags[i]);
+                }
+            }
+
+            // Load shader program source code
+            // Vertex program
+            std::string vp = PreprocessShader(vertPath, variant_defines);
+            const char *source_vp = vp.c_str();
+            // Fragment program
+            std::string fp = PreprocessShader(fragPath, variant_defines);
+            const char *source_fp = fp.c_str();
+
+            // Use the cached binary if there is one for these exact sources on this driver
+            variant.program = glCreateProgram();
+            variant.cache_key = cache.MakeKey(vp, fp);
+            if (cache.Load(variant.cache_key, variant.program)) {
+                continue;
+            }
+
+            // Create shaders from the program source code, status is only checked in Finish
+            variant.vertex_shader = glCreateShader(GL_VERTEX_SHADER);
+            glShaderSource(variant.vertex_shader, 1, &source_vp, NULL);
+            glCompileShader(variant.vertex_shader);
+
+            variant.fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
+            glShaderSource(variant.fragment_shader, 1, &source_fp, NULL);
+            glCompileShader(variant.fragment_shader);
+
+            // Create a shader program linking both vertex and fragment shaders together,
+            // asking the driver to keep its binary around for the cache
+            glAttachShader(variant.program, variant.vertex_shader);
+            glAttachShader(variant.program, variant.fragment_shader);
+            if (cache.IsEnabled()) {
+                glProgramParameteri(variant.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
+            glLinkProgram(variant.program);
         }
+    }
+
 
-        // Create a shader program linking both vertex and fragment shaders
-        // together
-        shader_program_ = glCreateProgram();
-        glAttachShader(shader_program_, vs);
-        glAttachShader(shader_program_, fs);
-        glLinkProgram(shader_program_);
-
-        // Check if shaders were linked successfully
-        glGetProgramiv(shader_program_, GL_LINK_STATUS, &status);
-        if (status != GL_TRUE) {
-            char buffer[512];
-            glGetShaderInfoLog(shader_program_, 512, NULL, buffer);
-            throw(std::ios_base::failure(std::string("Error linking shaders: ") + std::string(buffer)));
+    /*** Wait for compiling and linking to finish, then check for errors and cache the results ***/
+    void Shader::Finish(ShaderCache& cache) {
+        for (int i = 0; i < variants_.size(); ++i) {
+            Variant& variant = variants_[i];
+
+            // Loaded from the cache, nothing to wait for
+            if (!variant.vertex_shader) {
+                continue;
+            }
+
+            // Check if shaders compiled successfully
+            GLint status;
+            glGetShaderiv(variant.vertex_shader, GL_COMPILE_STATUS, &status);
+            if (status != GL_TRUE) {
+                char buffer[512];
+                glGetShaderInfoLog(variant.vertex_shader, 512, NULL, buffer);
+                throw(std::ios_base::failure(std::string("Error compiling vertex shader: ") + std::string(buffer)));
+            }
+
+            glGetShaderiv(variant.fragment_shader, GL_COMPILE_STATUS, &status);
+            if (status != GL_TRUE) {
+                char buffer[512];
+                glGetShaderInfoLog(variant.fragment_shader, 512, NULL, buffer);
+                throw(std::ios_base::failure(std::string("Error compiling fragment shader: ") + std::string(buffer)));
+            }
+
+            // Check if shaders were linked successfully
+            glGetProgramiv(variant.program, GL_LINK_STATUS, &status);
+            if (status != GL_TRUE) {
+                char buffer[512];
+                glGetProgramInfoLog(variant.program, 512, NULL, buffer);
+                throw(std::ios_base::failure(std::string("Error linking shaders: ") + std::string(buffer)));
+            }
+
+            // Delete memory used by shaders, since they were already compiled
+            // and linked
+            glDeleteShader(variant.vertex_shader);
+            glDeleteShader(variant.fragment_shader);
+            variant.vertex_shader = 0;
+            variant.fragment_shader = 0;
+
+            cache.Store(variant.cache_key, variant.program);
         }
+    }
 
-        // Delete memory used by shaders, since they were already compiled
-        // and linked
-        glDeleteShader(vs);
-        glDeleteShader(fs);
+
+    /*** Hand compiling off to the driver's threads, compiles then run in the background until their status is asked for ***/
+    void Shader::EnableParallelCompile(void) {
+#ifdef GL_KHR_parallel_shader_compile
+        if (GLEW_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        }
+#endif
     }
     
 
     /*** Allow a shader to be used ***/
     void Shader::Enable() {
-        glUseProgram(shader_program_);
+        glUseProgram(GetShaderProgram());
     }
 
 
@@ -90,26 +151,37 @@ namespace game {
 
     /*** Assorted Uniform Setters ***/
     void Shader::SetUniform1i(const GLchar *name, int value) {
-        glUniform1i(glGetUniformLocation(shader_program_, name), value);
+        glUniform1i(glGetUniformLocation(GetShaderProgram(), name), value);
     }
     void Shader::SetUniform1f(const GLchar *name, float value) {
-        glUniform1f(glGetUniformLocation(shader_program_, name), value);
+        glUniform1f(glGetUniformLocation(GetShaderProgram(), name), value);
     }
     void Shader::SetUniform2f(const GLchar *name, const glm::vec2 &vector) {
-        glUniform2f(glGetUniformLocation(shader_program_, name), vector.x, vector.y);
+        glUniform2f(glGetUniformLocation(GetShaderProgram(), name), vector.x, vector.y);
     }
     void Shader::SetUniform3f(const GLchar *name, const glm::vec3 &vector) {
-        glUniform3f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z);
+        glUniform3f(glGetUniformLocation(GetShaderProgram(), name), vector.x, vector.y, vector.z);
     }
     void Shader::SetUniform4f(const GLchar *name, const glm::vec4 &vector) {
-        glUniform4f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z, vector.w);
+        glUniform4f(glGetUniformLocation(GetShaderProgram(), name), vector.x, vector.y, vector.z, vector.w);
     }
     void Shader::SetUniformMat4(const GLchar *name, const glm::mat4 &matrix) {
-        glUniformMatrix4fv(glGetUniformLocation(shader_program_, name), 1, GL_FALSE, glm::value_ptr(matrix));
+        glUniformMatrix4fv(glGetUniformLocation(GetShaderProgram(), name), 1, GL_FALSE, glm::value_ptr(matrix));
     }
     void Shader::SetUniformIntArray(const GLchar* name, int len, const GLint* data){
 
-        glUniform1iv(glGetUniformLocation(shader_program_, name), len, data);
+        glUniform1iv(glGetUniformLocation(GetShaderProgram(), name), len, data);
+    }
+
+
+    /*** Point a uniform block at a buffer binding, in every variant since each is its own program ***/
+    void Shader::SetUniformBlockBinding(const GLchar* name, GLuint binding) {
+        for (int i = 0; i < variants_.size(); ++i) {
+            GLuint index = glGetUniformBlockIndex(variants_[i].program, name);
+            if (index != GL_INVALID_INDEX) {
+                glUniformBlockBinding(variants_[i].program, index, binding);
+            }
+        }
     }
 
 
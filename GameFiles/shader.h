@@ -8,22 +8,42 @@
 #include <glm/glm.hpp>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <glm/gtc/type_ptr.hpp>
 
-#include "file_utils.h"
+#include "shader_preprocessor.h"
+#include "shader_cache.h"
 
 namespace game {
 
-    // A class that stores a pair of vertex, fragment shaders
+    /* A class that stores a pair of vertex, fragment shaders, built into one program per variant.
+     * Each of the variant flags given to Begin is a #define a variant is compiled with or without,
+     * so n flags make 2^n variants, keyed by a bitmask in the order the flags were given.
+     * Enable, the uniform setters and GetShaderProgram all act on the selected variant */
     class Shader {
 
         public:
             Shader(void);
             ~Shader();
 
-            // Initialize shader with source files
+            // Initialize shader with source files, compiling straight away
             void Init(const char *vertPath, const char *fragPath);
 
+            /* Initialize in two steps so several shaders can compile at once: Begin loads the
+             * programs from the cache or submits them for compiling and linking without waiting,
+             * Finish waits for them, checks for errors and caches what was built. Begin every
+             * shader before Finishing any of them. Every variant gets all the defines */
+            void Begin(const char *vertPath, const char *fragPath, ShaderCache& cache,
+                const std::vector<std::string>& defines = std::vector<std::string>(),
+                const std::vector<std::string>& variant_flags = std::vector<std::string>());
+            void Finish(ShaderCache& cache);
+
+            // Pick the variant used from now on, keys with bits for flags this shader doesn't have fall back to 0
+            inline void SelectVariant(unsigned int key) { current_ = key < variants_.size() ? key : 0; }
+
+            // Let the driver compile on its own threads, if it can (GL_KHR_parallel_shader_compile)
+            static void EnableParallelCompile(void);
+
             // Enable or disable this specific shader
             void Enable();
             void Disable();
@@ -49,12 +69,26 @@ namespace game {
             // Sets a uniform int array variable in your shader program to an int array
             void SetUniformIntArray(const GLchar* name, int len, const GLint* data);
 
-            // Get OpenGL reference of shader program
-            inline GLuint GetShaderProgram(void) const { return shader_program_; }
+            // Binds a uniform block to a binding point in every variant, blocks a variant doesn't have are skipped
+            void SetUniformBlockBinding(const GLchar* name, GLuint binding);
+
+            // Get OpenGL reference of the selected variant's shader program
+            inline GLuint GetShaderProgram(void) const { return variants_[current_].program; }
 
         private:
-            // Reference to shader program
-            GLuint shader_program_;
+            struct Variant {
+                // Reference to shader program
+                GLuint program;
+
+                // Shaders still being compiled between Begin and Finish (0 once done or loaded from the cache)
+                GLuint vertex_shader;
+                GLuint fragment_shader;
+                unsigned long long cache_key;
+            };
+
+            // Every variant by key, and the selected one
+            std::vector<Variant> variants_;
+            unsigned int current_;
 
     }; // class Shader
 } // namespace game
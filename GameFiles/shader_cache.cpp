@@ -0,0 +1,183 @@
+// ShaderCache class definitions
+
+#include <fstream>
+#include <iostream>
+
+#include "shader_cache.h"
+
+namespace game {
+
+    // File header, the version is bumped whenever the layout below changes
+    static const unsigned int CACHE_MAGIC = 0x43534F43; // "COSC"
+    static const unsigned int CACHE_VERSION = 1;
+
+
+    /*** FNV-1a, folds a string into a running hash ***/
+    static unsigned long long HashString(unsigned long long hash, const std::string& str) {
+        for (int i = 0; i < str.size(); ++i) {
+            hash ^= static_cast<unsigned char>(str[i]);
+            hash *= 1099511628211ull;
+        }
+
+        // mark the end, so "ab" + "c" and "a" + "bc" differ
+        hash ^= 0xFF;
+        hash *= 1099511628211ull;
+        return hash;
+    }
+
+
+    /*** Default constructor, a disabled cache ***/
+    ShaderCache::ShaderCache(void) : enabled_(false), dirty_(false), hits_(0), misses_(0) {}
+
+
+    /*** Constructor, checks program binaries are supported then reads the cache file ***/
+    ShaderCache::ShaderCache(const std::string& path) : enabled_(false), path_(path), dirty_(false), hits_(0), misses_(0) {
+
+        // program binaries are core in 4.1, and otherwise need the extension
+        if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+            return;
+        }
+        GLint format_count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+        if (format_count <= 0) {
+            return;
+        }
+        enabled_ = true;
+
+        // binaries only work on the driver that made them
+        driver_ = std::string((const char*)glGetString(GL_VENDOR)) + "|"
+            + std::string((const char*)glGetString(GL_RENDERER)) + "|"
+            + std::string((const char*)glGetString(GL_VERSION));
+
+        // a missing file is a cold start, a broken one is treated the same
+        std::ifstream f(path_.c_str(), std::ios::binary);
+        if (!f) {
+            return;
+        }
+        unsigned int magic = 0, version = 0, count = 0;
+        f.read((char*)&magic, sizeof(magic));
+        f.read((char*)&version, sizeof(version));
+        f.read((char*)&count, sizeof(count));
+        if (!f || magic != CACHE_MAGIC || version != CACHE_VERSION) {
+            return;
+        }
+
+        for (unsigned int i = 0; i < count; ++i) {
+            unsigned long long key = 0;
+            unsigned int format = 0, size = 0;
+            f.read((char*)&key, sizeof(key));
+            f.read((char*)&format, sizeof(format));
+            f.read((char*)&size, sizeof(size));
+            if (!f) {
+                break;
+            }
+
+            Entry entry = { format, std::vector<char>(size), false };
+            f.read(entry.binary.data(), size);
+            if (!f) {
+                break;
+            }
+            entries_[key] = entry;
+        }
+    }
+
+
+    /*** Hash both sources together with the driver ***/
+    unsigned long long ShaderCache::MakeKey(const std::string& vertex_source, const std::string& fragment_source) const {
+        unsigned long long hash = 14695981039346656037ull;
+        hash = HashString(hash, vertex_source);
+        hash = HashString(hash, fragment_source);
+        hash = HashString(hash, driver_);
+        return hash;
+    }
+
+
+    /*** Hand the cached binary to the driver, it can still refuse it (e.g. after an update) ***/
+    bool ShaderCache::Load(unsigned long long key, GLuint program) {
+        if (!enabled_) {
+            return false;
+        }
+
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            misses_++;
+            return false;
+        }
+
+        Entry& entry = it->second;
+        glProgramBinary(program, entry.format, entry.binary.data(), (GLsizei)entry.binary.size());
+
+        GLint status;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            entries_.erase(it);
+            dirty_ = true;
+            misses_++;
+            return false;
+        }
+
+        entry.used = true;
+        hits_++;
+        return true;
+    }
+
+
+    /*** Read a linked program's binary back from the driver ***/
+    void ShaderCache::Store(unsigned long long key, GLuint program) {
+        if (!enabled_) {
+            return;
+        }
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) {
+            return;
+        }
+
+        Entry entry = { 0, std::vector<char>(length), true };
+        glGetProgramBinary(program, length, NULL, &entry.format, entry.binary.data());
+        entries_[key] = entry;
+        dirty_ = true;
+    }
+
+
+    /*** Write every entry used this run, a failed write only costs a recompile next time ***/
+    void ShaderCache::Save(void) {
+        if (!enabled_) {
+            return;
+        }
+
+        // drop entries nothing asked for, they belong to old sources or drivers
+        unsigned int count = 0;
+        for (auto& entry : entries_) {
+            if (entry.second.used) {
+                count++;
+            }
+        }
+        if (!dirty_ && count == entries_.size()) {
+            return;
+        }
+
+        std::ofstream f(path_.c_str(), std::ios::binary | std::ios::trunc);
+        if (!f) {
+            std::cerr << "Could not write shader cache " << path_ << std::endl;
+            return;
+        }
+        f.write((const char*)&CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        f.write((const char*)&CACHE_VERSION, sizeof(CACHE_VERSION));
+        f.write((const char*)&count, sizeof(count));
+        for (auto& entry : entries_) {
+            if (!entry.second.used) {
+                continue;
+            }
+            unsigned int format = entry.second.format;
+            unsigned int size = (unsigned int)entry.second.binary.size();
+            f.write((const char*)&entry.first, sizeof(entry.first));
+            f.write((const char*)&format, sizeof(format));
+            f.write((const char*)&size, sizeof(size));
+            f.write(entry.second.binary.data(), size);
+        }
+        dirty_ = false;
+    }
+
+} // namespace game
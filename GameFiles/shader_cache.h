@@ -0,0 +1,67 @@
+// ShaderCache class declarations, keeps linked shader program binaries on disk so later runs can skip compiling
+
+#ifndef SHADER_CACHE_H_
+#define SHADER_CACHE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace game {
+
+    /* Cache of linked program binaries, all kept in one file. Entries are
+     * keyed by a hash of the shader sources and the driver's vendor,
+     * renderer and version strings, so editing a shader or updating the
+     * driver just misses and recompiles. Only entries used during a run
+     * are written back, which drops stale ones. Needs a current GL context,
+     * and does nothing if the driver can't hand out program binaries */
+    class ShaderCache {
+
+        public:
+            // Cache that never hits and never saves
+            ShaderCache(void);
+
+            // Cache backed by a file, read right away if it exists
+            explicit ShaderCache(const std::string& path);
+
+            // Key for a pair of shader sources on this driver
+            unsigned long long MakeKey(const std::string& vertex_source, const std::string& fragment_source) const;
+
+            // Load a cached binary into a program, false if there's none or the driver rejected it
+            bool Load(unsigned long long key, GLuint program);
+
+            // Remember a freshly linked program's binary
+            void Store(unsigned long long key, GLuint program);
+
+            // Write the cache file, only if something new was stored
+            void Save(void);
+
+            // Whether binaries can be cached at all, programs should ask for a retrievable binary if so
+            inline bool IsEnabled(void) const { return enabled_; }
+
+            // Lookups this run
+            inline int GetHits(void) const { return hits_; }
+            inline int GetMisses(void) const { return misses_; }
+
+        private:
+            struct Entry {
+                GLenum format;
+                std::vector<char> binary;
+                bool used;
+            };
+
+            bool enabled_;
+            std::string path_;
+            std::string driver_;
+            std::unordered_map<unsigned long long, Entry> entries_;
+            bool dirty_;
+            int hits_;
+            int misses_;
+
+    }; // class ShaderCache
+
+} // namespace game
+
+#endif // SHADER_CACHE_H_
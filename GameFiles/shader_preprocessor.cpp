@@ -0,0 +1,106 @@
+// Shader preprocessor definitions
+
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+
+#include "shader_preprocessor.h"
+#include "file_utils.h"
+
+namespace game {
+
+    // What's been seen while expanding one source
+    struct PreprocessState {
+        std::vector<std::string> files;     // every file so far, index is its source string number
+        std::vector<std::string> open;      // files being expanded right now, to catch include loops
+        const std::vector<std::string>* defines;
+    };
+
+
+    /*** Directory part of a path, including the trailing slash ***/
+    static std::string DirectoryOf(const std::string& path) {
+        std::string::size_type slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+
+    /*** Expand one file into out, recursing into its includes ***/
+    static void ExpandFile(const std::string& path, PreprocessState& state, std::string& out) {
+        int file_index = state.files.size();
+        state.files.push_back(path);
+        state.open.push_back(path);
+
+        std::istringstream source(LoadTextFile(path.c_str()));
+        std::string line;
+        int line_number = 0;
+        while (std::getline(source, line)) {
+            line_number++;
+
+            // Only directives are looked at, everything else goes straight through
+            std::string::size_type start = line.find_first_not_of(" \t");
+            if (start == std::string::npos || line[start] != '#') {
+                out += line + "\n";
+                continue;
+            }
+            std::string directive = line.substr(start);
+
+            // Defines go right after the version, which has to stay the first thing in the source
+            if (directive.compare(0, 8, "#version") == 0) {
+                out += line + "\n";
+                if (file_index == 0) {
+                    for (int i = 0; i < state.defines->size(); ++i) {
+                        out += "#define " + (*state.defines)[i] + " 1\n";
+                    }
+                    std::ostringstream line_directive;
+                    line_directive << "#line " << line_number + 1 << " " << file_index << "\n";
+                    out += line_directive.str();
+                }
+                continue;
+            }
+
+            if (directive.compare(0, 8, "#include") == 0) {
+                std::string::size_type open_quote = directive.find('"');
+                std::string::size_type close_quote = directive.find('"', open_quote + 1);
+                if (open_quote == std::string::npos || close_quote == std::string::npos) {
+                    throw(std::ios_base::failure(std::string("Malformed #include in ") + path + ": " + line));
+                }
+                std::string include_path = DirectoryOf(path) + directive.substr(open_quote + 1, close_quote - open_quote - 1);
+
+                // A file still being expanded is also in files, so loops have to be caught before the once check drops them
+                if (std::find(state.open.begin(), state.open.end(), include_path) != state.open.end()) {
+                    throw(std::ios_base::failure(std::string("Shader includes itself: ") + include_path));
+                }
+
+                // Included once only, a second #include of the same file is dropped
+                if (std::find(state.files.begin(), state.files.end(), include_path) == state.files.end()) {
+                    std::ostringstream line_directive;
+                    line_directive << "#line 1 " << state.files.size() << "\n";
+                    out += line_directive.str();
+                    ExpandFile(include_path, state, out);
+                }
+
+                // Back in this file, on the line after the include
+                std::ostringstream line_directive;
+                line_directive << "#line " << line_number + 1 << " " << file_index << "\n";
+                out += line_directive.str();
+                continue;
+            }
+
+            out += line + "\n";
+        }
+
+        state.open.pop_back();
+    }
+
+
+    /*** Expand includes and add the defines ***/
+    std::string PreprocessShader(const std::string& path, const std::vector<std::string>& defines) {
+        PreprocessState state;
+        state.defines = &defines;
+
+        std::string out;
+        ExpandFile(path, state, out);
+        return out;
+    }
+
+} // namespace game
@@ -0,0 +1,22 @@
+// Shader preprocessor declarations, expands includes and adds defines to GLSL sources before they're compiled
+
+#ifndef SHADER_PREPROCESSOR_H_
+#define SHADER_PREPROCESSOR_H_
+
+#include <string>
+#include <vector>
+
+namespace game {
+
+    /* Load a shader source and get it ready to compile:
+     *  - each line of the form #include "file" is replaced by that file, looked up next to
+     *    the file including it. A file is only included once, and including itself is an error
+     *  - each name in defines becomes "#define NAME 1" right after the #version line, so the
+     *    source can #ifdef on it
+     * #line directives keep the driver's error messages pointing at the right line, with
+     * the main file as source string 0 and included files numbered in the order they appear */
+    std::string PreprocessShader(const std::string& path, const std::vector<std::string>& defines);
+
+} // namespace game
+
+#endif // SHADER_PREPROCESSOR_H_
@@ -53,14 +53,14 @@ namespace game {
 
 
     /*** Create a tiling piece of geometry ***/
-    void Sprite::CreateTilingGeometry(void) {
+    void Sprite::CreateTilingGeometry(float repeat) {
         GLfloat vertex[] = {
             // Four vertices of a square
             // Position      Color                Texture coordinates
-            -0.5f,  0.5f,    1.0f, 0.0f, 0.0f,    0.0f, 0.0f, // Top-left
-             0.5f,  0.5f,    0.0f, 1.0f, 0.0f,    5.0f, 0.0f, // Top-right
-             0.5f, -0.5f,    0.0f, 0.0f, 1.0f,    5.0f, 5.0f, // Bottom-right
-            -0.5f, -0.5f,    1.0f, 1.0f, 1.0f,    0.0f, 5.0f  // Bottom-left
+            -0.5f,  0.5f,    1.0f, 0.0f, 0.0f,    0.0f,   0.0f,   // Top-left
+             0.5f,  0.5f,    0.0f, 1.0f, 0.0f,    repeat, 0.0f,   // Top-right
+             0.5f, -0.5f,    0.0f, 0.0f, 1.0f,    repeat, repeat, // Bottom-right
+            -0.5f, -0.5f,    1.0f, 1.0f, 1.0f,    0.0f,   repeat  // Bottom-left
         };
 
         // Two triangles referencing the vertices
@@ -21,8 +21,8 @@ namespace game {
             // Create the geometry (called once)
             void CreateGeometry(void);
 
-            // Make the geometry tiling
-            void CreateTilingGeometry(void);
+            // Make the geometry tiling, the texture repeats this many times along each side
+            void CreateTilingGeometry(float repeat);
 
             // Use the geometry
             void SetGeometry(GLuint shader_program);
@@ -1,32 +1,32 @@
-// Source code of fragment shader
+// Source code of fragment shader, GHOST makes the grayed out variant,
+// OPAQUE the one that only draws fully covered texels for the depth pass
 #version 130
 
-// Attributes passed from the vertex shader
-in vec4 color_interp;
-in vec2 uv_interp;
-
-// Texture sampler
-uniform sampler2D onetex;
-
-// Ghost mode declaration
-uniform bool ghost;
+#include "fragment_inputs.glsl"
 
 void main() {
 
     // Sample texture
     vec4 color = texture2D(onetex, uv_interp);
 
+#ifdef GHOST
     // Apply ghost mode corrections
-    if (ghost) {
-        float gray = (color.r + color.g + color.b) / 3.0;
-        color.rgb = vec3(gray);
-    }
+    float gray = (color.r + color.g + color.b) / 3.0;
+    color.rgb = vec3(gray);
+#endif
 
     // Assign color to fragment
     gl_FragColor = color;
 
+#ifdef OPAQUE
+    // Anything see-through is left to the blended pass
+    if (color.a < 1.0) {
+         discard;
+    }
+#else
     // Discard objects that are too transparent
     if (color.a < 0.01) {
          discard;
     }
+#endif
 }
@@ -1,14 +1,17 @@
 // Source code of vertex shader
 #version 130
 
-// Vertex buffer
-in vec2 vertex;
+// Per-frame block with the view, first since it enables an extension
+#include "frame_uniforms.glsl"
+
+// Vertex buffer, the quad leaves z at 0 and batched sprites carry their depth in it
+in vec3 vertex;
 in vec3 color;
 in vec2 uv;
 
 // Uniform (global) buffer
 uniform mat4 transformation_matrix;
-uniform mat4 view_matrix;
+uniform float depth;
 
 // Attributes forwarded to the fragment shader
 out vec4 color_interp;
@@ -17,8 +20,11 @@ out vec2 uv_interp;
 void main()
 {
     // Transform vertex
-    vec4 vertex_pos = vec4(vertex, 0.0, 1.0);
+    vec4 vertex_pos = vec4(vertex.xy, 0.0, 1.0);
     gl_Position = view_matrix * transformation_matrix * vertex_pos;
+
+    // Depth is the draw order the render queue gave it, the view is orthographic so w is 1
+    gl_Position.z = depth + vertex.z;
     
     // Pass attributes to fragment shader
     color_interp = vec4(color, 1.0);
@@ -0,0 +1,107 @@
+// StaticLayer class definitions
+
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "static_layer.h"
+#include "defs.h"
+
+namespace game {
+
+    /*** Constructor, the target is made on the first refresh ***/
+    StaticLayer::StaticLayer(void)
+        : framebuffer_(0), texture_(0), pixels_(0), valid_(false),
+          center_(0.0f), size_(0.0f), view_pixels_(0), sprite_count_(0), refresh_time_(0.0) {}
+
+
+    /*** Destructor, frees the target ***/
+    StaticLayer::~StaticLayer() {
+        glDeleteFramebuffers(1, &framebuffer_);
+        glDeleteTextures(1, &texture_);
+    }
+
+
+    /*** Out of date if the view left the cached rect, the window changed, sprites came or went, or the spin is due ***/
+    bool StaticLayer::NeedsRefresh(const glm::vec2& view_center, const glm::vec2& view_size, const glm::ivec2& view_pixels,
+        int sprite_count, double time) const {
+
+        if (!valid_ || view_pixels != view_pixels_ || sprite_count != sprite_count_) {
+            return true;
+        }
+        if (time - refresh_time_ >= STATIC_LAYER_REFRESH_INTERVAL) {
+            return true;
+        }
+
+        // the whole view has to be inside what's cached
+        glm::vec2 slack = (size_ - view_size) * 0.5f;
+        glm::vec2 offset = glm::abs(view_center - center_);
+        return offset.x > slack.x || offset.y > slack.y;
+    }
+
+
+    /*** Size the target to the view plus its margin at the window's pixel density, then bind it ***/
+    glm::mat4 StaticLayer::BeginRefresh(const glm::vec2& view_center, const glm::vec2& view_size, const glm::ivec2& view_pixels,
+        int sprite_count, double time) {
+
+        center_ = view_center;
+        size_ = view_size + glm::vec2(STATIC_LAYER_MARGIN * 2.0f);
+        view_pixels_ = view_pixels;
+        sprite_count_ = sprite_count;
+        refresh_time_ = time;
+        valid_ = true;
+
+        glm::vec2 pixels_per_unit = glm::vec2(view_pixels) / view_size;
+        Resize(glm::ivec2(
+            (int)std::ceil(size_.x * pixels_per_unit.x),
+            (int)std::ceil(size_.y * pixels_per_unit.y)
+        ));
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+        glViewport(0, 0, pixels_.x, pixels_.y);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // maps the cached rect onto the whole target
+        return glm::scale(glm::mat4(1.0f), glm::vec3(2.0f / size_.x, 2.0f / size_.y, 1.0f))
+            * glm::translate(glm::mat4(1.0f), glm::vec3(-center_, 0.0f));
+    }
+
+
+    /*** Back to drawing into the window ***/
+    void StaticLayer::EndRefresh(const glm::ivec2& view_pixels) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, view_pixels.x, view_pixels.y);
+    }
+
+
+    /*** Quad over the cached rect, flipped vertically since render targets start at the bottom row and sprite UVs at the top ***/
+    glm::mat4 StaticLayer::GetTransform(void) const {
+        return glm::translate(glm::mat4(1.0f), glm::vec3(center_, 0.0f))
+            * glm::scale(glm::mat4(1.0f), glm::vec3(size_.x, -size_.y, 1.0f));
+    }
+
+
+    /*** Make the color texture and framebuffer the first time, and reallocate the texture when the size changes ***/
+    void StaticLayer::Resize(const glm::ivec2& pixels) {
+        if (framebuffer_ != 0 && pixels == pixels_) {
+            return;
+        }
+        pixels_ = pixels;
+
+        if (framebuffer_ == 0) {
+            glGenTextures(1, &texture_);
+            glBindTexture(GL_TEXTURE_2D, texture_);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glGenFramebuffers(1, &framebuffer_);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, texture_);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, pixels_.x, pixels_.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
+    }
+
+} // namespace game
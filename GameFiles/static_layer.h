@@ -0,0 +1,59 @@
+// StaticLayer class declarations, an offscreen copy of the background sprites so they aren't redrawn every frame
+
+#ifndef STATIC_LAYER_H_
+#define STATIC_LAYER_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    /* Render target holding the background sprites (portals, buy areas, the win image) as they
+     * looked at the last refresh. It covers the view plus STATIC_LAYER_MARGIN on every side, so
+     * the camera can drift that far before it has to be redrawn, and is otherwise only refreshed
+     * every STATIC_LAYER_REFRESH_INTERVAL for the spin animations. It's cleared to transparent
+     * and drawn into with pre-multiplied alpha, so it composites over the starfield like the
+     * sprites themselves would. Main thread only */
+    class StaticLayer {
+
+        public:
+            StaticLayer(void);
+            ~StaticLayer();
+
+            // Whether the cache is out of date for a view (center and size in world units, pixels of the window)
+            bool NeedsRefresh(const glm::vec2& view_center, const glm::vec2& view_size, const glm::ivec2& view_pixels,
+                int sprite_count, double time) const;
+
+            /* Bind the cache as the render target for a refresh around the view, and get the view matrix
+             * to draw with. EndRefresh puts the window back as the target */
+            glm::mat4 BeginRefresh(const glm::vec2& view_center, const glm::vec2& view_size, const glm::ivec2& view_pixels,
+                int sprite_count, double time);
+            void EndRefresh(const glm::ivec2& view_pixels);
+
+            // Texture and transform to draw the cache with, as a sprite on the regular quad
+            inline GLuint GetTexture(void) const { return texture_; }
+            glm::mat4 GetTransform(void) const;
+
+        private:
+            // (Re)create the target at a size, does nothing if it's already that size
+            void Resize(const glm::ivec2& pixels);
+
+            GLuint framebuffer_;
+            GLuint texture_;
+            glm::ivec2 pixels_;
+
+            // What the cache currently holds: the world rect it covers, the window it was made for,
+            // how many sprites went into it and when
+            bool valid_;
+            glm::vec2 center_;
+            glm::vec2 size_;
+            glm::ivec2 view_pixels_;
+            int sprite_count_;
+            double refresh_time_;
+
+    }; // class StaticLayer
+
+} // namespace game
+
+#endif // STATIC_LAYER_H_
@@ -0,0 +1,129 @@
+// StreamRing class definitions
+
+#include "stream_ring.h"
+
+namespace game {
+
+    /*** Constructor, the buffer is made in Init ***/
+    StreamRing::StreamRing(void)
+        : target_(GL_ARRAY_BUFFER), buffer_(0), frame_size_(0), persistent_(false),
+          mapped_(NULL), frame_(0), used_(0), allocation_mapped_(false) {
+        for (int i = 0; i < STREAM_RING_FRAMES; ++i) {
+            fences_[i] = 0;
+        }
+    }
+
+
+    /*** Destructor, unmaps and frees the buffer ***/
+    StreamRing::~StreamRing() {
+        for (int i = 0; i < STREAM_RING_FRAMES; ++i) {
+            if (fences_[i]) {
+                glDeleteSync(fences_[i]);
+            }
+        }
+        if (mapped_) {
+            glBindBuffer(target_, buffer_);
+            glUnmapBuffer(target_);
+        }
+        glDeleteBuffers(1, &buffer_);
+    }
+
+
+    /*** Use immutable persistently mapped storage if the driver has it, otherwise a plain buffer to orphan ***/
+    void StreamRing::Init(GLenum target, GLsizeiptr frame_size) {
+        target_ = target;
+        frame_size_ = frame_size;
+
+        glGenBuffers(1, &buffer_);
+        glBindBuffer(target_, buffer_);
+
+        persistent_ = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+        if (persistent_) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(target_, frame_size_ * STREAM_RING_FRAMES, NULL, flags);
+            mapped_ = (char*)glMapBufferRange(target_, 0, frame_size_ * STREAM_RING_FRAMES, flags);
+            if (mapped_) {
+                return;
+            }
+
+            // mapping failed, storage can't be respecified so start over with a plain buffer
+            glDeleteBuffers(1, &buffer_);
+            glGenBuffers(1, &buffer_);
+            glBindBuffer(target_, buffer_);
+            persistent_ = false;
+        }
+        glBufferData(target_, frame_size_, NULL, GL_STREAM_DRAW);
+    }
+
+
+    /*** Start writing a new region ***/
+    void StreamRing::BeginFrame(void) {
+        used_ = 0;
+
+        if (!persistent_) {
+            // orphan, the old storage lives on until the draws reading it are done
+            glBindBuffer(target_, buffer_);
+            glBufferData(target_, frame_size_, NULL, GL_STREAM_DRAW);
+            return;
+        }
+
+        frame_ = (frame_ + 1) % STREAM_RING_FRAMES;
+        GLsync fence = fences_[frame_];
+        if (!fence) {
+            return;
+        }
+
+        // flush on the first wait so the fence is sure to be reached, then just keep waiting
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while (true) {
+            GLenum result = glClientWaitSync(fence, flags, STREAM_RING_WAIT_NS);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) {
+                break;
+            }
+            flags = 0;
+        }
+        glDeleteSync(fence);
+        fences_[frame_] = 0;
+    }
+
+
+    /*** Fence this frame's region, nothing to do for the fallback since it orphans ***/
+    void StreamRing::EndFrame(void) {
+        if (persistent_ && used_ > 0) {
+            fences_[frame_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+
+    /*** Take the next aligned piece of the frame's region ***/
+    void* StreamRing::Allocate(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset) {
+        GLsizeiptr start = (used_ + alignment - 1) / alignment * alignment;
+        if (start + size > frame_size_) {
+            return NULL;
+        }
+        used_ = start + size;
+
+        if (persistent_) {
+            offset = frame_ * frame_size_ + start;
+            return mapped_ + offset;
+        }
+
+        // nothing drawn this frame has used this range yet, so there's nothing to synchronize with
+        offset = start;
+        glBindBuffer(target_, buffer_);
+        void* data = glMapBufferRange(target_, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        allocation_mapped_ = data != NULL;
+        return data;
+    }
+
+
+    /*** Finish writing the last allocation, the persistent mapping is coherent so only the fallback has to unmap ***/
+    void StreamRing::Commit(void) {
+        if (allocation_mapped_) {
+            glBindBuffer(target_, buffer_);
+            glUnmapBuffer(target_);
+            allocation_mapped_ = false;
+        }
+    }
+
+} // namespace game
@@ -0,0 +1,71 @@
+// StreamRing class declarations, a ring of per-frame regions in one buffer for vertex data written every frame
+
+#ifndef STREAM_RING_H_
+#define STREAM_RING_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "defs.h"
+
+namespace game {
+
+    /* Hands out space for data that's written by the CPU and drawn from in the same frame.
+     *
+     * With ARB_buffer_storage the buffer holds STREAM_RING_FRAMES regions and stays mapped for
+     * good (persistent, coherent). Each frame writes to the next region, and a fence placed at
+     * the end of the frame is waited on before that region comes round again, so the CPU only
+     * ever stalls if the GPU is that many frames behind.
+     *
+     * Without it there's one region, orphaned at the start of every frame so the driver can
+     * hand out fresh memory while the last frame's draws still read the old one, and each
+     * allocation is mapped unsynchronized and unmapped again by Commit.
+     *
+     * Main thread only, BeginFrame and EndFrame bracket everything drawn from it in a frame */
+    class StreamRing {
+
+        public:
+            StreamRing(void);
+            ~StreamRing();
+
+            // Create the buffer for a target (e.g. GL_ARRAY_BUFFER) with this much space per frame
+            void Init(GLenum target, GLsizeiptr frame_size);
+
+            // Move to the next region, waiting for the GPU to be done with it if needed
+            void BeginFrame(void);
+
+            // Fence what was drawn from this frame's region
+            void EndFrame(void);
+
+            /* Space for size bytes at a multiple of alignment from the start of the buffer, or NULL
+             * when the frame's region is full. offset is where it is in the buffer, to point
+             * attributes at. Write it, then Commit before drawing from it */
+            void* Allocate(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset);
+            void Commit(void);
+
+            // Getters
+            inline GLuint GetBuffer(void) const { return buffer_; }
+            inline bool IsPersistent(void) const { return persistent_; }
+            inline GLsizeiptr GetUsed(void) const { return used_; }
+
+        private:
+            GLenum target_;
+            GLuint buffer_;
+            GLsizeiptr frame_size_;
+            bool persistent_;
+
+            // Persistent mapping of the whole buffer, and the fence of each region (0 if none)
+            char* mapped_;
+            GLsync fences_[STREAM_RING_FRAMES];
+
+            // Region being written, how much of it is handed out, and whether an allocation is mapped (fallback only)
+            int frame_;
+            GLsizeiptr used_;
+            bool allocation_mapped_;
+
+    }; // class StreamRing
+
+} // namespace game
+
+#endif // STREAM_RING_H_
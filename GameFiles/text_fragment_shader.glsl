@@ -1,12 +1,10 @@
-// Source code of fragment shader
+// Source code of fragment shader, GLYPHS makes the variant that writes text,
+// without it the texture is shown as is
 #version 130
 
-// Attributes passed from the vertex shader
-in vec4 color_interp;
-in vec2 uv_interp;
+#include "fragment_inputs.glsl"
 
-// Texture sampler
-uniform sampler2D onetex;
+#ifdef GLYPHS
 
 // Configuration of the font texture
 // Number of characters per row
@@ -20,12 +18,13 @@ float char_height = 1/float(num_rows);
 // Text input
 uniform int text_len;
 uniform int text_content[40];
+#endif
 
 
 void main()
 {
-    // Check if we are writing on this sprite
-    if (text_len > 0){
+#ifdef GLYPHS
+    {
         // Find which character we are writing in the block covered by
         // this fragment
         // Get the index of the character in the text string according
@@ -59,7 +58,9 @@ void main()
         {
              discard;
         }
-    } else {
+    }
+#else
+    {
         // Show the texture
         // Sample texture
         vec4 color = texture2D(onetex, uv_interp);
@@ -73,4 +74,5 @@ void main()
              discard;
         }
     }
+#endif
 }
@@ -23,8 +23,8 @@ namespace game {
             inline std::string GetText(void) const { return text_; }
             inline void SetText(std::string text) { text_ = text; }
 
-            // Render function for the text
-            void Render(const glm::mat4& view_matrix, double current_time) override;
+            // Text goes in the snapshot's text list whatever the layer
+            void AddToSnapshot(RenderSnapshot& snapshot, SnapshotLayer layer) const override;
 
         private:
             std::string text_;
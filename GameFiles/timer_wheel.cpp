@@ -0,0 +1,204 @@
+// TimerWheel class definitions
+
+#include <algorithm>
+#include <cmath>
+
+#include "timer_wheel.h"
+
+namespace game {
+
+    // Mask for a slot index within one level
+    static const unsigned long long SLOT_MASK = TIMER_WHEEL_SLOTS - 1;
+
+    // Number of ticks the whole wheel spans, timers further out than this wait in the top level
+    static const unsigned long long WHEEL_SPAN = 1ull << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS);
+
+
+    /*** Constructor, the wheel starts empty at time 0 ***/
+    TimerWheel::TimerWheel(void) : free_(-1), time_(0.0), tick_(0) {
+        for (int level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+            for (int slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot) {
+                slots_[level][slot] = -1;
+            }
+        }
+    }
+
+
+    /*** Take a free node, fill it in and put it on the wheel ***/
+    TimerHandle TimerWheel::Schedule(float delay, TimerListener* listener, int timer_id) {
+
+        // reuse a node if there is one
+        int index;
+        if (free_ >= 0) {
+            index = free_;
+            free_ = nodes_[index].next;
+        }
+        else {
+            index = static_cast<int>(nodes_.size());
+            nodes_.push_back({ 0, nullptr, 0, 1, -1, -1, -1, -1 });
+        }
+
+        // round up to the first tick at or after the due time, so timers never fire early, and never fire
+        // on the tick we're already on
+        unsigned long long expiry = tick_ + 1;
+        if (delay > 0.0f) {
+            expiry = std::max(expiry, static_cast<unsigned long long>(std::ceil((time_ + delay) / TIMER_WHEEL_TICK)));
+        }
+
+        Node& node = nodes_[index];
+        node.expiry = expiry;
+        node.listener = listener;
+        node.timer_id = timer_id;
+        Insert(index);
+
+        return (static_cast<unsigned long long>(node.generation) << 32) | static_cast<unsigned int>(index);
+    }
+
+
+    /*** Take a timer off the wheel and free its node ***/
+    void TimerWheel::Cancel(TimerHandle handle) {
+        int index = Find(handle);
+        if (index < 0) {
+            return;
+        }
+
+        Node& node = nodes_[index];
+        if (node.level >= 0) {
+            Unlink(index);
+        }
+
+        // bump the generation so the handle goes stale
+        node.listener = nullptr;
+        node.generation = node.generation + 1 == 0 ? 1 : node.generation + 1;
+        node.next = free_;
+        free_ = index;
+    }
+
+
+    /*** A timer is pending until it fires or is cancelled ***/
+    bool TimerWheel::IsPending(TimerHandle handle) const {
+        return Find(handle) >= 0;
+    }
+
+
+    /*** Step the clock tick by tick, moving timers down the levels and collecting the ones that come due ***/
+    void TimerWheel::Advance(double delta_time) {
+        time_ += delta_time;
+        unsigned long long target = static_cast<unsigned long long>(time_ / TIMER_WHEEL_TICK);
+
+        while (tick_ < target) {
+            tick_++;
+
+            // every level that just finished a turn pulls the next slot of the one above down
+            for (int level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+                int shift = level * TIMER_WHEEL_SLOT_BITS;
+                if ((tick_ & ((1ull << shift) - 1)) != 0) {
+                    break;
+                }
+                Cascade(level, static_cast<int>((tick_ >> shift) & SLOT_MASK));
+            }
+
+            // everything in this level 0 slot is due on this tick
+            int slot = static_cast<int>(tick_ & SLOT_MASK);
+            while (slots_[0][slot] >= 0) {
+                int index = slots_[0][slot];
+                Unlink(index);
+                due_.push_back((static_cast<unsigned long long>(nodes_[index].generation) << 32) | static_cast<unsigned int>(index));
+            }
+        }
+
+        // fire them, a listener can schedule new timers or cancel ones that haven't fired yet
+        for (std::size_t i = 0; i < due_.size(); ++i) {
+            int index = Find(due_[i]);
+            if (index < 0) {
+                continue;
+            }
+            TimerListener* listener = nodes_[index].listener;
+            int timer_id = nodes_[index].timer_id;
+            Cancel(due_[i]);
+            listener->OnTimer(timer_id);
+        }
+        due_.clear();
+    }
+
+
+    /*** Put a node in the lowest level whose turn reaches its expiry ***/
+    void TimerWheel::Insert(int index) {
+        Node& node = nodes_[index];
+
+        // anything past the end of the wheel sits in the last slot it can reach and is moved again later
+        unsigned long long expiry = node.expiry;
+        if (expiry - tick_ >= WHEEL_SPAN) {
+            expiry = tick_ + WHEEL_SPAN - 1;
+        }
+        unsigned long long diff = expiry - tick_;
+
+        int level = 0;
+        while (level < TIMER_WHEEL_LEVELS - 1 && diff >= (1ull << ((level + 1) * TIMER_WHEEL_SLOT_BITS))) {
+            level++;
+        }
+        int slot = static_cast<int>((expiry >> (level * TIMER_WHEEL_SLOT_BITS)) & SLOT_MASK);
+
+        // push it on the front of the slot's list
+        int head = slots_[level][slot];
+        node.level = level;
+        node.slot = slot;
+        node.prev = -1;
+        node.next = head;
+        if (head >= 0) {
+            nodes_[head].prev = index;
+        }
+        slots_[level][slot] = index;
+    }
+
+
+    /*** Unlink a node from its slot's list ***/
+    void TimerWheel::Unlink(int index) {
+        Node& node = nodes_[index];
+
+        if (node.prev >= 0) {
+            nodes_[node.prev].next = node.next;
+        }
+        else {
+            slots_[node.level][node.slot] = node.next;
+        }
+        if (node.next >= 0) {
+            nodes_[node.next].prev = node.prev;
+        }
+
+        node.prev = -1;
+        node.next = -1;
+        node.level = -1;
+        node.slot = -1;
+    }
+
+
+    /*** Empty a slot and re-insert its timers, which are now close enough for a lower level ***/
+    void TimerWheel::Cascade(int level, int slot) {
+        int index = slots_[level][slot];
+        slots_[level][slot] = -1;
+
+        while (index >= 0) {
+            int next = nodes_[index].next;
+            Insert(index);
+            index = next;
+        }
+    }
+
+
+    /*** Split a handle into its node and generation, the node has to still be on that generation ***/
+    int TimerWheel::Find(TimerHandle handle) const {
+        int index = static_cast<int>(handle & 0xFFFFFFFFull);
+        unsigned int generation = static_cast<unsigned int>(handle >> 32);
+
+        if (handle == 0 || index >= static_cast<int>(nodes_.size())) {
+            return -1;
+        }
+        const Node& node = nodes_[index];
+        if (node.generation != generation || node.listener == nullptr) {
+            return -1;
+        }
+        return index;
+    }
+
+} // namespace game
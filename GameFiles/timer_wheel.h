@@ -0,0 +1,92 @@
+// TimerWheel class declarations, schedules one-shot timers and fires them without polling every one each tick
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "defs.h"
+
+namespace game {
+
+    // Handle to a scheduled timer, 0 means none. Handles of fired or cancelled timers are never reused
+    typedef unsigned long long TimerHandle;
+
+
+    // Anything that wants to be told when its timers fire
+    class TimerListener {
+
+        public:
+            virtual ~TimerListener(void) {}
+
+            // Called when a timer scheduled for this listener fires, with the id it was scheduled with
+            virtual void OnTimer(int timer_id) = 0;
+    };
+
+
+    /* Hierarchical timer wheel. Time is cut into ticks of TIMER_WHEEL_TICK
+     * seconds, and each level is a ring of TIMER_WHEEL_SLOTS lists. Level 0
+     * holds timers due within one turn of its ring, level 1 those due within
+     * one turn of its own (each slot covering a whole turn of level 0), and so
+     * on. Every time a level finishes a turn, the next slot of the level above
+     * is emptied down into it. Scheduling and cancelling are O(1), and advancing
+     * only touches the timers that fire plus the ones being moved down.
+     *
+     * The wheel keeps its own clock, moved forward by Advance, so a wheel can
+     * run slower than real time. Listeners must cancel their timers before
+     * they're destroyed. Not thread safe, it is only touched by the simulation */
+    class TimerWheel {
+
+        public:
+            TimerWheel(void);
+
+            // Schedule a timer to fire after delay seconds of this wheel's time
+            TimerHandle Schedule(float delay, TimerListener* listener, int timer_id);
+
+            // Stop a timer from firing, does nothing if it already fired or was cancelled
+            void Cancel(TimerHandle handle);
+
+            // Whether a timer is still waiting to fire
+            bool IsPending(TimerHandle handle) const;
+
+            // Move the clock forward and fire every timer that came due, in order
+            void Advance(double delta_time);
+
+            // Seconds on this wheel's clock
+            inline double GetTime(void) const { return time_; }
+
+        private:
+            struct Node {
+                unsigned long long expiry;  // tick it fires on
+                TimerListener* listener;
+                int timer_id;
+                unsigned int generation;    // bumped every time the node is freed, stale handles don't match
+                int prev, next;             // neighbours in its slot, or the next free node
+                int level, slot;            // where it is, level is -1 while not scheduled
+            };
+
+            // Put a node in the slot for its expiry, or unlink it from whichever slot it's in
+            void Insert(int index);
+            void Unlink(int index);
+
+            // Move every timer in a slot down to the levels below
+            void Cascade(int level, int slot);
+
+            // Node a handle points at, or -1 if the handle is stale
+            int Find(TimerHandle handle) const;
+
+            std::vector<Node> nodes_;
+            int free_;
+            int slots_[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+
+            double time_;
+            unsigned long long tick_;
+
+            // Timers that came due during one Advance, fired once the wheel is settled
+            std::vector<TimerHandle> due_;
+    };
+
+} // namespace game
+
+#endif // TIMER_WHEEL_H_
@@ -1,5 +1,8 @@
 // Definitions for the Wave and WaveControl classes
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 #include "waves.h"
 
 namespace game {
@@ -9,8 +12,9 @@ namespace game {
 	/********************/
 
 	/*** Contructor, initializes member vars and calcaultes enemies_alive ***/
-	Wave::Wave(int gunner_count, int chaser_count, int kamikaze_count)
-		: gunner_count(gunner_count), chaser_count(chaser_count), kamikaze_count(kamikaze_count) {
+	Wave::Wave(int gunner_count, int chaser_count, int kamikaze_count, float health_scale, float speed_scale)
+		: gunner_count(gunner_count), chaser_count(chaser_count), kamikaze_count(kamikaze_count),
+		health_scale(health_scale), speed_scale(speed_scale) {
 		enemies_alive = gunner_count + chaser_count + kamikaze_count;
 	}
 
@@ -26,40 +30,83 @@ namespace game {
 	/* WaveControl Definitions */
 	/***************************/
 
-	/*** Contructor, initializes all the waves and default values for member vars ***/
+	/*** Contructor, default values for member vars, the waves themselves come from LoadFromFile ***/
 	WaveControl::WaveControl() {
 
 		current_wave = 0;
 		enemies_left_in_wave = 0;
 
-		Wave wave1 (0, 8, 0);
-		Wave wave2 (0, 16, 0);
-		Wave wave3 (4, 12, 0);
-		Wave wave4 (2, 16, 0);
-		Wave wave5 (6, 12, 1);
-		Wave wave6 (0, 20, 2);
-		Wave wave7 (0, 0, 20);
-		Wave wave8 (5, 25, 5);
-		Wave wave9 (15, 15, 5);
-		Wave wave10 (20, 30, 15);
-
-		// needed for debugging win screen
-		//current_wave = 9;
-		//Wave wave10 (0, 0, 1);
-
-		waves.insert(waves.end(), { wave1, wave2, wave3, wave4, wave5, wave6, wave7, wave8, wave9, wave10 });
+		settings.max_enemies = MAX_ENEMIES;
+		settings.spawn_batch = 1;
+		settings.spawn_delay = ENEMY_SPAWN_DELAY;
+		settings.wave_delay = WAVE_START_DELAY;
+
+		wave_file_time = 0;
+	}
+
+
+	/*** Read all the waves and spawn settings from a data file ***/
+	void WaveControl::LoadFromFile(const char* filename) {
+		std::vector<Wave> parsed_waves;
+		WaveSettings parsed_settings = settings;
+
+		ParseFile(filename, parsed_waves, parsed_settings);
+
+		waves = parsed_waves;
+		settings = parsed_settings;
+		current_wave = 0;
+
+		wave_file = filename;
+		wave_file_time = GetModifiedTime(filename);
+	}
+
+
+	/*** Reload the data file if it changed, the wave in progress keeps its remaining enemies ***/
+	bool WaveControl::ReloadIfChanged(void) {
+		if (wave_file.empty()) {
+			return false;
+		}
+
+		std::time_t modified = GetModifiedTime(wave_file.c_str());
+		if (modified == 0 || modified == wave_file_time) {
+			return false;
+		}
+		wave_file_time = modified;
+
+		// a bad edit shouldn't end the game, keep playing the old waves and report it
+		std::vector<Wave> parsed_waves;
+		WaveSettings parsed_settings = settings;
+		try {
+			ParseFile(wave_file.c_str(), parsed_waves, parsed_settings);
+		}
+		catch (std::exception& e) {
+			std::cerr << "Wave reload failed: " << e.what() << std::endl;
+			return false;
+		}
+		if (parsed_waves.size() <= current_wave) {
+			std::cerr << "Wave reload failed: file has fewer waves than have been played" << std::endl;
+			return false;
+		}
+
+		// the enemies of the current wave have partly spawned already, so it carries over as is
+		parsed_waves[current_wave] = waves[current_wave];
+		waves = parsed_waves;
+		settings = parsed_settings;
+
+		std::cout << "Reloaded " << waves.size() << " waves from " << wave_file << std::endl;
+		return true;
 	}
 
 
 	/*** Decrease the count of an enemy type, indicating it has spawned ***/
-	void WaveControl::DecrementEnemyCount(int enemy_type) {
-		if (enemy_type == 1) {
+	void WaveControl::DecrementEnemyCount(EnemyType enemy_type) {
+		if (enemy_type == ENEMY_GUNNER) {
 			waves[current_wave].DecrementGunnerCount();
 		}
-		if (enemy_type == 2) {
+		if (enemy_type == ENEMY_CHASER) {
 			waves[current_wave].DecrementChaserCount();
 		}
-		if (enemy_type == 3) {
+		if (enemy_type == ENEMY_KAMIKAZE) {
 			waves[current_wave].DecrementKamikazeCount();
 		}
 		// Debug only
@@ -69,7 +116,7 @@ namespace game {
 
 	/*** Go to the next wave, avoid OOB errors, indicate success ***/
 	bool WaveControl::IncrementWave(void) {
-		if (current_wave < MAX_WAVES - 1) {
+		if (current_wave + 1 < waves.size()) {
 			current_wave++;
 			return true;
 		}
@@ -77,4 +124,81 @@ namespace game {
 		return false;
 	}
 	
+
+
+	/*** Parse the wave file format, one setting or wave per line, '#' starts a comment ***/
+	void WaveControl::ParseFile(const char* filename, std::vector<Wave>& parsed_waves, WaveSettings& parsed_settings) const {
+
+		std::ifstream f(filename);
+		if (f.fail()) {
+			throw(std::ios_base::failure(std::string("Error opening file ") + std::string(filename)));
+		}
+
+		std::vector<Wave> result;
+		WaveSettings result_settings = parsed_settings;
+
+		std::string line;
+		int line_number = 0;
+		while (std::getline(f, line)) {
+			line_number++;
+			line = line.substr(0, line.find('#'));
+
+			std::istringstream tokens(line);
+			std::string key;
+			if (!(tokens >> key)) {
+				continue; // blank or comment line
+			}
+
+			bool ok = false;
+			if (key == "max_enemies") {
+				ok = static_cast<bool>(tokens >> result_settings.max_enemies) && result_settings.max_enemies > 0;
+			}
+			else if (key == "spawn_batch") {
+				ok = static_cast<bool>(tokens >> result_settings.spawn_batch) && result_settings.spawn_batch > 0;
+			}
+			else if (key == "spawn_delay") {
+				ok = static_cast<bool>(tokens >> result_settings.spawn_delay) && result_settings.spawn_delay >= 0.0f;
+			}
+			else if (key == "wave_delay") {
+				ok = static_cast<bool>(tokens >> result_settings.wave_delay) && result_settings.wave_delay >= 0.0f;
+			}
+			else if (key == "wave") {
+				int gunners, chasers, kamikazes;
+				float health_scale = 1.0f, speed_scale = 1.0f;
+				ok = static_cast<bool>(tokens >> gunners >> chasers >> kamikazes)
+					&& gunners >= 0 && chasers >= 0 && kamikazes >= 0;
+
+				// the scales are optional
+				if (ok && tokens >> health_scale) {
+					tokens >> speed_scale;
+				}
+				if (ok) {
+					result.push_back(Wave(gunners, chasers, kamikazes, health_scale, speed_scale));
+				}
+			}
+
+			if (!ok) {
+				throw(std::runtime_error(std::string(filename) + ":" + std::to_string(line_number)
+					+ ": can't parse \"" + line + "\""));
+			}
+		}
+
+		if (result.empty()) {
+			throw(std::runtime_error(std::string(filename) + ": no waves defined"));
+		}
+
+		parsed_waves = result;
+		parsed_settings = result_settings;
+	}
+
+
+	/*** Last time a file was written to, 0 if it can't be found ***/
+	std::time_t WaveControl::GetModifiedTime(const char* filename) const {
+		struct stat info;
+		if (stat(filename, &info) != 0) {
+			return 0;
+		}
+		return info.st_mtime;
+	}
+
 } // namespace game
@@ -4,7 +4,12 @@
 #define WAVES_H_
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <vector>
+#include <ctime>
+#include <stdexcept>
 #include "game_object.h"
 #include "defs.h"
 #include "derived_enemy_objects.h"
@@ -15,7 +20,7 @@ namespace game {
     class Wave {
     public:
         // Constructor
-        Wave(int gunner_count, int chaser_count, int kamikaze_count);
+        Wave(int gunner_count, int chaser_count, int kamikaze_count, float health_scale = 1.0f, float speed_scale = 1.0f);
 
         // For debugging
         void Print() const;
@@ -25,6 +30,8 @@ namespace game {
         inline int GetChaserCount(void) const { return chaser_count; }
         inline int GetKamikazeCount(void) const { return kamikaze_count; }
         inline int GetEnemiesAlive(void) const { return enemies_alive; }
+        inline float GetHealthScale(void) const { return health_scale; }
+        inline float GetSpeedScale(void) const { return speed_scale; }
 
         // Decrement enemy counts
         inline void DecrementGunnerCount(void) { gunner_count--; }
@@ -33,16 +40,32 @@ namespace game {
         inline void DecrementEnemiesAlive(void) { enemies_alive--; }
 
     private :
-        unsigned short int chaser_count, gunner_count, kamikaze_count, enemies_alive;
+        unsigned int chaser_count, gunner_count, kamikaze_count, enemies_alive;
+        float health_scale, speed_scale;
     };
 
 
-    // WaveControl Class -> Holds all the waves to be played out in the game
+    // WaveSettings -> Spawn settings shared by every wave
+    struct WaveSettings {
+        int max_enemies;    // never have more than this many enemies at once
+        int spawn_batch;    // enemies spawned per spawn tick, spread across the portals
+        float spawn_delay;  // seconds between spawn ticks
+        float wave_delay;   // pause after a wave is cleared
+    };
+
+
+    // WaveControl Class -> Holds all the waves to be played out in the game, read from a data file
     class WaveControl {
     public:
         // Constructor
         WaveControl();
 
+        // Read the waves and spawn settings from a file, throws if it can't be read or parsed
+        void LoadFromFile(const char* filename);
+
+        // Load the file again if it was saved since the last load, returns true if it was
+        bool ReloadIfChanged(void);
+
         // Get which wave currently being played
         inline int GetCurrentWave(void) const { return current_wave + 1; }
 
@@ -52,19 +75,36 @@ namespace game {
         // Increment wave counter
         bool IncrementWave(void);
 
-        // Decrement count of enemy based on parameter int
-        void DecrementEnemyCount(int enemy_type);
+        // Decrement count of enemy based on its type
+        void DecrementEnemyCount(EnemyType enemy_type);
 
         // Helpers for handling enemies left in the wave
         inline int EnemiesAlive(void) const { return waves[current_wave].GetEnemiesAlive(); }
         inline void EnemyExploded(void) { waves[current_wave].DecrementEnemiesAlive(); }
 
+        // Spawn settings from the data file
+        inline int GetWaveCount(void) const { return waves.size(); }
+        inline int GetMaxEnemies(void) const { return settings.max_enemies; }
+        inline int GetSpawnBatch(void) const { return settings.spawn_batch; }
+        inline float GetSpawnDelay(void) const { return settings.spawn_delay; }
+        inline float GetWaveDelay(void) const { return settings.wave_delay; }
+
     private:
+        // Parse a wave file into the out params, leaves them untouched on failure
+        void ParseFile(const char* filename, std::vector<Wave>& parsed_waves, WaveSettings& parsed_settings) const;
+
+        // Last modification time of a file, 0 if it can't be found
+        std::time_t GetModifiedTime(const char* filename) const;
+
         std::vector<Wave> waves;
-        unsigned short int current_wave;
-        unsigned short int enemies_left_in_wave;
+        unsigned int current_wave;
+        unsigned int enemies_left_in_wave;
+
+        WaveSettings settings;
 
-        const unsigned short int MAX_WAVES = 10;
+        // Where the waves came from, for hot reloading
+        std::string wave_file;
+        std::time_t wave_file_time;
     };
 
 } // namespace game
@@ -0,0 +1,159 @@
+// WorldChunks class definitions
+
+#include <cmath>
+#include <algorithm>
+
+#include "world_chunks.h"
+
+namespace game {
+
+    // Portal ring of one sector relative to its middle, the 8 spawn points on the outside of the original arena
+    static const glm::vec3 SECTOR_PORTALS[] = {
+        glm::vec3(16.0f, -9.0f, 0.0f), glm::vec3(16.0f, 9.0f, 0.0f),
+        glm::vec3(9.0f, 16.0f, 0.0f), glm::vec3(-9.0f, 16.0f, 0.0f),
+        glm::vec3(-16.0f, 9.0f, 0.0f), glm::vec3(-16.0f, -9.0f, 0.0f),
+        glm::vec3(-9.0f, -16.0f, 0.0f), glm::vec3(9.0f, -16.0f, 0.0f)
+    };
+
+
+    /*** Constructor, lays out the portals of every sector, nothing is loaded until the first Stream ***/
+    WorldChunks::WorldChunks(Geometry* portal_geom, Shader* shader, GLuint portal_texture)
+        : portal_geom_(portal_geom), shader_(shader), portal_texture_(portal_texture),
+          center_x_(-1), center_y_(-1), spawn_sector_(-1) {
+
+        chunks_per_side_ = WORLD_SECTORS * WORLD_SECTOR_CHUNKS;
+
+        // bucket each sector's portals by the chunk they're in
+        float sector_size = WORLD_SECTOR_CHUNKS * WORLD_CHUNK_SIZE;
+        for (int sy = 0; sy < WORLD_SECTORS; ++sy) {
+            for (int sx = 0; sx < WORLD_SECTORS; ++sx) {
+                glm::vec3 sector_middle(
+                    -WORLD_SIZE * 0.5f + (sx + 0.5f) * sector_size,
+                    -WORLD_SIZE * 0.5f + (sy + 0.5f) * sector_size,
+                    0.0f
+                );
+                for (int i = 0; i < sizeof(SECTOR_PORTALS) / sizeof(SECTOR_PORTALS[0]); ++i) {
+                    glm::vec3 position = sector_middle + SECTOR_PORTALS[i];
+                    portal_layout_[ChunkIndex(ChunkCoord(position.x), ChunkCoord(position.y))].push_back(position);
+                }
+            }
+        }
+    }
+
+
+    /*** Destructor, frees whatever is still loaded ***/
+    WorldChunks::~WorldChunks() {
+        for (auto& entry : resident_) {
+            Unload(entry.second);
+        }
+    }
+
+
+    /*** Stream chunks in and out, only does any work when the center moves into another chunk ***/
+    void WorldChunks::Stream(const glm::vec3& center) {
+        int cx = ChunkCoord(center.x);
+        int cy = ChunkCoord(center.y);
+        if (cx == center_x_ && cy == center_y_) {
+            return;
+        }
+        center_x_ = cx;
+        center_y_ = cy;
+
+        // unload chunks one past the stream radius, the extra chunk stops chunks on the edge flickering in and out
+        for (auto it = resident_.begin(); it != resident_.end();) {
+            int x = it->first % chunks_per_side_;
+            int y = it->first / chunks_per_side_;
+            if (std::abs(x - cx) > WORLD_STREAM_RADIUS + 1 || std::abs(y - cy) > WORLD_STREAM_RADIUS + 1) {
+                Unload(it->second);
+                it = resident_.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        // load the ones in range that aren't yet
+        int min_x = std::max(cx - WORLD_STREAM_RADIUS, 0), max_x = std::min(cx + WORLD_STREAM_RADIUS, chunks_per_side_ - 1);
+        int min_y = std::max(cy - WORLD_STREAM_RADIUS, 0), max_y = std::min(cy + WORLD_STREAM_RADIUS, chunks_per_side_ - 1);
+        for (int y = min_y; y <= max_y; ++y) {
+            for (int x = min_x; x <= max_x; ++x) {
+                if (resident_.find(ChunkIndex(x, y)) == resident_.end()) {
+                    Load(x, y);
+                }
+            }
+        }
+
+        CollectResident();
+    }
+
+
+    /*** Column (or row) of the chunk a coordinate is in, clamped to the world ***/
+    int WorldChunks::ChunkCoord(float x) const {
+        int chunk = (int)std::floor((x + WORLD_SIZE * 0.5f) / WORLD_CHUNK_SIZE);
+        return std::min(std::max(chunk, 0), chunks_per_side_ - 1);
+    }
+
+
+    /*** Create a chunk's portals, chunks without any are still tracked so Stream knows they're loaded ***/
+    void WorldChunks::Load(int x, int y) {
+        Chunk& chunk = resident_[ChunkIndex(x, y)];
+
+        auto layout = portal_layout_.find(ChunkIndex(x, y));
+        if (layout != portal_layout_.end()) {
+            for (int i = 0; i < layout->second.size(); ++i) {
+                chunk.portals.push_back(new EnemySpawn(layout->second[i], portal_geom_, shader_, portal_texture_));
+            }
+        }
+    }
+
+
+    /*** Free a chunk's objects ***/
+    void WorldChunks::Unload(Chunk& chunk) {
+        for (int i = 0; i < chunk.portals.size(); ++i) {
+            delete chunk.portals[i];
+        }
+        chunk.portals.clear();
+    }
+
+
+    /*** Flatten the resident chunks' portals into one list, ordered by chunk index ***/
+    void WorldChunks::CollectResident(void) {
+        std::vector<int> indices;
+        indices.reserve(resident_.size());
+        for (auto& entry : resident_) {
+            indices.push_back(entry.first);
+        }
+        std::sort(indices.begin(), indices.end());
+
+        portals_.clear();
+        for (int i = 0; i < indices.size(); ++i) {
+            const Chunk& chunk = resident_[indices[i]];
+            portals_.insert(portals_.end(), chunk.portals.begin(), chunk.portals.end());
+        }
+    }
+
+
+    /*** Gather a sector's portal positions from the layout, only redone when the point moves into another sector ***/
+    const std::vector<glm::vec3>& WorldChunks::GetSpawnPoints(const glm::vec3& center) {
+        int sx = ChunkCoord(center.x) / WORLD_SECTOR_CHUNKS;
+        int sy = ChunkCoord(center.y) / WORLD_SECTOR_CHUNKS;
+        int sector = sy * WORLD_SECTORS + sx;
+        if (sector == spawn_sector_) {
+            return spawn_points_;
+        }
+        spawn_sector_ = sector;
+
+        // chunk order, so dealing out a batch is repeatable
+        spawn_points_.clear();
+        for (int y = sy * WORLD_SECTOR_CHUNKS; y < (sy + 1) * WORLD_SECTOR_CHUNKS; ++y) {
+            for (int x = sx * WORLD_SECTOR_CHUNKS; x < (sx + 1) * WORLD_SECTOR_CHUNKS; ++x) {
+                auto layout = portal_layout_.find(ChunkIndex(x, y));
+                if (layout != portal_layout_.end()) {
+                    spawn_points_.insert(spawn_points_.end(), layout->second.begin(), layout->second.end());
+                }
+            }
+        }
+        return spawn_points_;
+    }
+
+} // namespace game
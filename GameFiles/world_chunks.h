@@ -0,0 +1,84 @@
+// WorldChunks class declarations, splits the world into chunks and only keeps the ones near the camera loaded
+
+#ifndef WORLD_CHUNKS_H_
+#define WORLD_CHUNKS_H_
+
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+#include "enemy_spawn.h"
+#include "defs.h"
+
+namespace game {
+
+    /* The world is a grid of square chunks, WORLD_SECTOR_CHUNKS chunks to a
+     * sector. Every sector is laid out like the original arena, with a ring
+     * of spawn portals around its middle. Only the chunks within
+     * WORLD_STREAM_RADIUS of the camera's chunk are resident, each with
+     * whichever portals fall inside it, so the cost of drawing and updating
+     * the world doesn't grow with its size. The background itself is drawn
+     * procedurally by the screen shader and needs no objects.
+     * Chunks are loaded and unloaded by Stream, on the simulation thread */
+    class WorldChunks {
+
+        public:
+            // Constructor, with what the portals are drawn with
+            WorldChunks(Geometry* portal_geom, Shader* shader, GLuint portal_texture);
+
+            // Destructor, unloads every resident chunk
+            ~WorldChunks();
+
+            // Load the chunks around a point and unload the ones that drifted out of range
+            void Stream(const glm::vec3& center);
+
+            // Resident portals, in chunk order so iterating them is repeatable
+            inline const std::vector<EnemySpawn*>& GetPortals(void) const { return portals_; }
+
+            // Portal positions of the whole sector around a point, resident or not, what enemies spawn from
+            const std::vector<glm::vec3>& GetSpawnPoints(const glm::vec3& center);
+
+            // Side length of the whole world, centered on the origin
+            inline float GetSize(void) const { return WORLD_SIZE; }
+
+        private:
+            struct Chunk {
+                std::vector<EnemySpawn*> portals;
+            };
+
+            // Chunk containing a world coordinate, and a chunk's index in the grid
+            int ChunkCoord(float x) const;
+            inline int ChunkIndex(int x, int y) const { return y * chunks_per_side_ + x; }
+
+            // Create or destroy one chunk's objects
+            void Load(int x, int y);
+            void Unload(Chunk& chunk);
+
+            // Rebuild portals_ from the resident chunks
+            void CollectResident(void);
+
+            Geometry* portal_geom_;
+            Shader* shader_;
+            GLuint portal_texture_;
+
+            int chunks_per_side_;
+
+            // Portal positions of every chunk that has any, worked out once from the sector layout
+            std::unordered_map<int, std::vector<glm::vec3> > portal_layout_;
+
+            // Resident chunks by index, and the chunk they were streamed around (-1 before the first Stream)
+            std::unordered_map<int, Chunk> resident_;
+            int center_x_, center_y_;
+
+            std::vector<EnemySpawn*> portals_;
+
+            // Spawn points of the last sector asked for (-1 before the first GetSpawnPoints)
+            std::vector<glm::vec3> spawn_points_;
+            int spawn_sector_;
+
+    }; // class WorldChunks
+
+} // namespace game
+
+#endif // WORLD_CHUNKS_H_